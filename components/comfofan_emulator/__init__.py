@@ -0,0 +1,71 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.const import CONF_CHANNEL, CONF_ID
+from esphome.core import CORE
+
+DEPENDENCIES = ["nrf905", "zehnder"]
+
+CONF_BROADCAST_INTERVAL = "broadcast_interval"
+CONF_DROP_RATE = "drop_rate"
+CONF_DUPLICATES = "duplicates"
+CONF_MAIN_UNIT_ID = "main_unit_id"
+CONF_NETWORK_ID = "network_id"
+CONF_PAIRING = "pairing"
+CONF_REMOTE_ID = "remote_id"
+CONF_REPLY_DELAY = "reply_delay"
+CONF_REPLY_JITTER = "reply_jitter"
+CONF_SEED = "seed"
+
+comfofan_emulator_ns = cg.esphome_ns.namespace("comfofan_emulator")
+ComfoFanEmulator = comfofan_emulator_ns.class_("ComfoFanEmulator", cg.Component)
+
+
+def validate_host(config):
+    if not CORE.is_host:
+        raise cv.Invalid("The ComfoFan emulator only runs on the host platform")
+    return config
+
+
+CONFIG_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.GenerateID(): cv.declare_id(ComfoFanEmulator),
+            cv.Optional(CONF_CHANNEL, default=118): cv.int_range(min=0, max=511),
+            cv.Optional(CONF_NETWORK_ID, default=0x89ABCDEF): cv.hex_uint32_t,
+            cv.Optional(CONF_MAIN_UNIT_ID, default=0x42): cv.int_range(min=1, max=254),
+            cv.Optional(
+                CONF_REPLY_DELAY, default="20ms"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(
+                CONF_REPLY_JITTER, default="0ms"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_DROP_RATE, default=0.0): cv.percentage,
+            cv.Optional(CONF_DUPLICATES, default=0): cv.int_range(min=0, max=10),
+            cv.Optional(
+                CONF_BROADCAST_INTERVAL, default="0s"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_PAIRING, default=True): cv.boolean,
+            cv.Optional(CONF_SEED, default=1): cv.uint32_t,
+            # The wall remote remoteSetSpeed() plays
+            cv.Optional(CONF_REMOTE_ID, default=0x77): cv.int_range(min=1, max=254),
+        }
+    ).extend(cv.COMPONENT_SCHEMA),
+    validate_host,
+)
+
+
+async def to_code(config):
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+
+    cg.add(var.set_channel(config[CONF_CHANNEL]))
+    cg.add(var.set_network_id(config[CONF_NETWORK_ID]))
+    cg.add(var.set_main_unit_id(config[CONF_MAIN_UNIT_ID]))
+    cg.add(var.set_reply_delay(config[CONF_REPLY_DELAY]))
+    cg.add(var.set_reply_jitter(config[CONF_REPLY_JITTER]))
+    cg.add(var.set_drop_rate(config[CONF_DROP_RATE]))
+    cg.add(var.set_duplicates(config[CONF_DUPLICATES]))
+    cg.add(var.set_broadcast_interval(config[CONF_BROADCAST_INTERVAL]))
+    cg.add(var.set_pairing(config[CONF_PAIRING]))
+    cg.add(var.set_seed(config[CONF_SEED]))
+    cg.add(var.set_remote_id(config[CONF_REMOTE_ID]))
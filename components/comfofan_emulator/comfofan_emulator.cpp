@@ -0,0 +1,423 @@
+#include "comfofan_emulator.h"
+
+#ifdef USE_HOST
+
+#include "esphome/core/log.h"
+
+#include <algorithm>
+#include <string.h>
+
+namespace esphome {
+namespace comfofan_emulator {
+
+static const char *const TAG = "comfofan_emulator";
+
+using nrf905::global_air_medium;
+using nrf905::hal::micros;
+using nrf905::hal::millis;
+using zehnder::RfFrame;
+
+static const char *const operationNames[OperationCount] = {"Pair", "Query", "SetSpeed", "SetVoltage"};
+
+// Output voltage (percent) per speed preset
+static const uint8_t speedVoltage[] = {0, 30, 50, 90, 100};
+
+// 4 byte addresses, 16 byte frames, CRC16: what the bridge configures
+static const uint32_t packetTime = nrf905::AirMedium::packetTime(4, FAN_FRAMESIZE, 2);
+
+static uint32_t percentile(std::vector<uint32_t> values, const uint8_t percent) {
+  const size_t rank = (values.size() * percent) / 100;
+
+  if (values.empty()) {
+    return 0;
+  }
+  std::nth_element(values.begin(), values.begin() + std::min(rank, values.size() - 1), values.end());
+  return values[std::min(rank, values.size() - 1)];
+}
+
+void ComfoFanEmulator::setup() {
+  global_air_medium.attach(this);
+  this->lastBroadcast_ = millis();
+}
+
+void ComfoFanEmulator::dump_config() {
+  ESP_LOGCONFIG(TAG, "ComfoFan emulator:");
+  ESP_LOGCONFIG(TAG, "  Channel: %u", this->channel_);
+  ESP_LOGCONFIG(TAG, "  Network ID: 0x%08X", this->networkId_);
+  ESP_LOGCONFIG(TAG, "  Main unit ID: 0x%02X", this->mainUnitId_);
+  ESP_LOGCONFIG(TAG, "  Reply delay: %u ms (+%u ms jitter)", this->replyDelay_, this->replyJitter_);
+  ESP_LOGCONFIG(TAG, "  Drop rate: %.2f", this->dropRate_);
+  ESP_LOGCONFIG(TAG, "  Duplicates: %u", this->duplicates_);
+  if (this->broadcastInterval_ > 0) {
+    ESP_LOGCONFIG(TAG, "  Broadcast interval: %u ms", this->broadcastInterval_);
+  }
+  ESP_LOGCONFIG(TAG, "  Pairing: %s", this->pairing_ ? "open" : "closed");
+}
+
+void ComfoFanEmulator::loop() {
+  uint32_t now;
+
+  if ((this->timer_ > 0) && ((int32_t) (millis() - this->timerEnd_) >= 0)) {
+    ESP_LOGD(TAG, "Timer expired, back to speed %u", this->timerRestoreSpeed_);
+    this->setSpeed(this->timerRestoreSpeed_);
+  }
+  if ((this->broadcastInterval_ > 0) && ((millis() - this->lastBroadcast_) >= this->broadcastInterval_)) {
+    this->broadcastSettings();
+  }
+
+  // Finishes our packet on air, if any, and may hand us new requests
+  global_air_medium.update();
+
+  // Transmissions leave one at a time, each after the channel is clear
+  now = micros();
+  if (!this->pending_.empty() && !this->pending_.front().onAir &&
+      ((int32_t) (now - this->pending_.front().start) >= 0)) {
+    Transmission *transmission = &this->pending_.front();
+
+    if (this->carrier_) {
+      transmission->start = now + packetTime;
+    } else {
+      transmission->onAir = true;
+      global_air_medium.transmit(this, now, now + packetTime, transmission->address,
+                                 (const uint8_t *) &transmission->frame, FAN_FRAMESIZE);
+    }
+  }
+
+  if (this->pending_.empty()) {
+    this->highFreq_.stop();
+  }
+}
+
+void ComfoFanEmulator::setSpeed(const uint8_t speed, const uint8_t timer) {
+  this->applySpeed(speed, timer);
+  this->broadcastSettings();
+}
+
+void ComfoFanEmulator::remoteSetSpeed(const uint8_t speed, const uint8_t timer) {
+  RfFrame request;
+  RfFrame reply;
+
+  (void) memset(&request, 0, sizeof(RfFrame));
+  request.rx_type = zehnder::FAN_TYPE_MAIN_UNIT;
+  request.rx_id = this->mainUnitId_;
+  request.tx_type = zehnder::FAN_TYPE_REMOTE_CONTROL;
+  request.tx_id = this->remoteId_;
+  request.ttl = FAN_TTL;
+  if (timer == 0) {
+    request.command = zehnder::FAN_FRAME_SETSPEED;
+    request.parameter_count = sizeof(zehnder::RfPayloadFanSetSpeed);
+    request.payload.setSpeed.speed = speed;
+  } else {
+    request.command = zehnder::FAN_FRAME_SETTIMER;
+    request.parameter_count = sizeof(zehnder::RfPayloadFanSetTimer);
+    request.payload.setTimer.speed = speed;
+    request.payload.setTimer.timer = timer;
+  }
+  ESP_LOGD(TAG, "Remote %02X:%02X sets speed %u (timer %u)", request.tx_type, request.tx_id, speed, timer);
+  this->queue(this->networkId_, &request, OperationCount, false, 0);
+
+  this->applySpeed(speed, timer);
+  this->makeReply(&request, zehnder::FAN_FRAME_SETSPEED_REPLY, &reply);
+  this->queue(this->networkId_, &reply, OperationCount, false, this->replyDelay_);
+}
+
+void ComfoFanEmulator::applySpeed(const uint8_t speed, const uint8_t timer) {
+  if ((timer > 0) && (this->timer_ == 0)) {
+    this->timerRestoreSpeed_ = this->speed_;
+  }
+
+  this->speed_ = std::min(speed, (uint8_t) zehnder::FAN_SPEED_MAX);
+  this->voltage_ = speedVoltage[this->speed_];
+  this->timer_ = timer;
+  this->timerEnd_ = millis() + (timer * 60000UL);
+}
+
+bool ComfoFanEmulator::airAddressMatch(const uint32_t address) {
+  return (address == this->networkId_) || (this->pairing_ && (address == NETWORK_LINK_ID));
+}
+
+bool ComfoFanEmulator::airReceive(const uint32_t address, const uint8_t *const pPayload, const uint8_t length) {
+  // Half duplex
+  if (!this->pending_.empty() && this->pending_.front().onAir) {
+    return false;
+  }
+
+  if (length < sizeof(RfFrame)) {
+    ++this->ignoredFrames_;
+  } else {
+    this->handleFrame(address, (const RfFrame *) pPayload);
+  }
+
+  return true;
+}
+
+void ComfoFanEmulator::airTransmitted(const uint8_t receivers) {
+  if (this->pending_.empty() || !this->pending_.front().onAir) {
+    return;
+  }
+
+  const Transmission transmission = this->pending_.front();
+  this->pending_.erase(this->pending_.begin());
+  this->transmitted(&transmission, receivers > 0);
+}
+
+void ComfoFanEmulator::handleFrame(const uint32_t address, const RfFrame *const frame) {
+  Operation operation;
+  RfFrame reply;
+
+  switch (frame->command) {
+    case zehnder::FAN_NETWORK_JOIN_REQUEST:
+    case zehnder::FAN_FRAME_0B:
+      operation = OperationPair;
+      break;
+
+    case zehnder::FAN_TYPE_QUERY_DEVICE:
+      operation = OperationQuery;
+      break;
+
+    case zehnder::FAN_FRAME_SETSPEED:
+    case zehnder::FAN_FRAME_SETTIMER:
+      operation = OperationSetSpeed;
+      break;
+
+    case zehnder::FAN_FRAME_SETVOLTAGE:
+      operation = OperationSetVoltage;
+      break;
+
+    default:
+      ESP_LOGV(TAG, "Ignoring command 0x%02X", frame->command);
+      ++this->ignoredFrames_;
+      return;
+  }
+
+  // Discovery: a remote looks for an open network on the link address
+  if (address == NETWORK_LINK_ID) {
+    if ((frame->command != zehnder::FAN_NETWORK_JOIN_REQUEST) || (frame->rx_type != zehnder::FAN_TYPE_BROADCAST) ||
+        !this->pairing_) {
+      ++this->ignoredFrames_;
+      return;
+    }
+
+    this->beginOperation(OperationPair);
+    ++this->stats_[OperationPair].requestFrames;
+    this->stats_[OperationPair].airtime += packetTime;
+
+    ESP_LOGD(TAG, "Join request from %02X:%02X, offering network 0x%08X", frame->tx_type, frame->tx_id,
+             this->networkId_);
+    this->makeReply(frame, zehnder::FAN_NETWORK_JOIN_OPEN, &reply);
+    reply.parameter_count = sizeof(zehnder::RfPayloadNetworkJoinOpen);
+    reply.payload.networkJoinOpen.networkId = this->networkId_;
+    this->send(NETWORK_LINK_ID, &reply, OperationPair, false);
+    return;
+  }
+
+  if ((address != this->networkId_) || (frame->rx_type != zehnder::FAN_TYPE_MAIN_UNIT) ||
+      (frame->rx_id != this->mainUnitId_)) {
+    ++this->ignoredFrames_;
+    return;
+  }
+
+  this->beginOperation(operation);
+  ++this->stats_[operation].requestFrames;
+  this->stats_[operation].airtime += packetTime;
+
+  switch (frame->command) {
+    case zehnder::FAN_NETWORK_JOIN_REQUEST:
+      if (frame->payload.networkJoinRequest.networkId != this->networkId_) {
+        ESP_LOGW(TAG, "Join request for foreign network 0x%08X", frame->payload.networkJoinRequest.networkId);
+        return;
+      }
+      this->makeReply(frame, zehnder::FAN_FRAME_0B, &reply);
+      this->send(this->networkId_, &reply, OperationPair, false);
+      break;
+
+    case zehnder::FAN_FRAME_0B:
+      this->makeReply(frame, zehnder::FAN_TYPE_QUERY_NETWORK, &reply);
+      this->send(this->networkId_, &reply, OperationPair, true);
+      break;
+
+    case zehnder::FAN_TYPE_QUERY_DEVICE:
+      this->makeReply(frame, zehnder::FAN_TYPE_FAN_SETTINGS, &reply);
+      this->fillSettings(&reply);
+      this->send(this->networkId_, &reply, OperationQuery, true);
+      break;
+
+    case zehnder::FAN_FRAME_SETSPEED:
+      ESP_LOGD(TAG, "Set speed %u from %02X:%02X", frame->payload.setSpeed.speed, frame->tx_type, frame->tx_id);
+      this->applySpeed(frame->payload.setSpeed.speed);
+      this->makeReply(frame, zehnder::FAN_FRAME_SETSPEED_REPLY, &reply);
+      this->send(this->networkId_, &reply, OperationSetSpeed, true);
+      break;
+
+    case zehnder::FAN_FRAME_SETTIMER:
+      ESP_LOGD(TAG, "Set speed %u for %u min from %02X:%02X", frame->payload.setTimer.speed,
+               frame->payload.setTimer.timer, frame->tx_type, frame->tx_id);
+      this->applySpeed(frame->payload.setTimer.speed, frame->payload.setTimer.timer);
+      this->makeReply(frame, zehnder::FAN_FRAME_SETSPEED_REPLY, &reply);
+      this->send(this->networkId_, &reply, OperationSetSpeed, true);
+      break;
+
+    case zehnder::FAN_FRAME_SETVOLTAGE:
+      ESP_LOGD(TAG, "Set voltage %u%% from %02X:%02X", frame->payload.setVoltage.voltage, frame->tx_type,
+               frame->tx_id);
+      this->voltage_ = std::min(frame->payload.setVoltage.voltage, (uint8_t) 100);
+      this->makeReply(frame, zehnder::FAN_FRAME_SETVOLTAGE_REPLY, &reply);
+      this->send(this->networkId_, &reply, OperationSetVoltage, true);
+      break;
+  }
+}
+
+void ComfoFanEmulator::makeReply(const RfFrame *const request, const uint8_t command, RfFrame *const reply) {
+  (void) memset(reply, 0, sizeof(RfFrame));
+  reply->rx_type = request->tx_type;
+  reply->rx_id = request->tx_id;
+  reply->tx_type = zehnder::FAN_TYPE_MAIN_UNIT;
+  reply->tx_id = this->mainUnitId_;
+  reply->ttl = FAN_TTL;
+  reply->command = command;
+}
+
+void ComfoFanEmulator::fillSettings(RfFrame *const frame) {
+  const uint32_t remaining = (this->timer_ > 0) ? ((this->timerEnd_ - millis()) + 59999) / 60000 : 0;
+
+  frame->parameter_count = sizeof(zehnder::RfPayloadFanSettings);
+  frame->payload.fanSettings.speed = this->speed_;
+  frame->payload.fanSettings.voltage = this->voltage_;
+  frame->payload.fanSettings.timer = (uint8_t) std::min(remaining, (uint32_t) 0xFF);
+}
+
+void ComfoFanEmulator::broadcastSettings(void) {
+  RfFrame frame;
+
+  (void) memset(&frame, 0, sizeof(RfFrame));
+  frame.rx_type = zehnder::FAN_TYPE_BROADCAST;
+  frame.tx_type = zehnder::FAN_TYPE_MAIN_UNIT;
+  frame.tx_id = this->mainUnitId_;
+  frame.ttl = FAN_TTL;
+  frame.command = zehnder::FAN_TYPE_FAN_SETTINGS;
+  this->fillSettings(&frame);
+
+  this->queue(this->networkId_, &frame, OperationCount, false, 0);
+  this->lastBroadcast_ = millis();
+}
+
+void ComfoFanEmulator::send(const uint32_t address, const RfFrame *const frame, const Operation operation,
+                            const bool confirms) {
+  const uint32_t delay = this->replyDelay_ + ((this->replyJitter_ > 0) ? this->random() % (this->replyJitter_ + 1) : 0);
+
+  if ((this->dropRate_ > 0.0f) && ((this->random() % 10000) < (uint32_t) (this->dropRate_ * 10000))) {
+    ESP_LOGD(TAG, "Dropping reply 0x%02X", frame->command);
+    ++this->stats_[operation].droppedReplies;
+    return;
+  }
+
+  for (uint8_t i = 0; i <= this->duplicates_; ++i) {
+    this->queue(address, frame, operation, confirms, delay);
+  }
+}
+
+void ComfoFanEmulator::queue(const uint32_t address, const RfFrame *const frame, const Operation operation,
+                             const bool confirms, const uint32_t delay) {
+  Transmission transmission;
+
+  transmission.start = micros() + (delay * 1000);
+  transmission.address = address;
+  transmission.frame = *frame;
+  transmission.operation = operation;
+  transmission.confirms = confirms;
+  transmission.onAir = false;
+
+  this->pending_.push_back(transmission);
+  this->highFreq_.start();
+}
+
+void ComfoFanEmulator::transmitted(const Transmission *const transmission, const bool taken) {
+  uint32_t latency;
+
+  if (transmission->operation == OperationCount) {
+    ++this->broadcastFrames_;
+    return;
+  }
+
+  OperationStats *stats = &this->stats_[transmission->operation];
+  ++stats->replyFrames;
+  stats->airtime += packetTime;
+
+  ESP_LOGV(TAG, "Reply 0x%02X %s", transmission->frame.command, taken ? "received" : "missed");
+
+  if (!taken || !transmission->confirms || !this->operationOpen_[transmission->operation]) {
+    return;
+  }
+
+  latency = millis() - this->operationStart_[transmission->operation];
+  this->operationOpen_[transmission->operation] = false;
+  ++stats->confirmed;
+  stats->totalLatency += latency;
+  this->latencies_[transmission->operation].push_back(latency);
+  if (latency > stats->maxLatency) {
+    stats->maxLatency = latency;
+  }
+
+  if (transmission->operation == OperationPair) {
+    ESP_LOGI(TAG, "Paired with %02X:%02X after %u ms", transmission->frame.rx_type, transmission->frame.rx_id,
+             latency);
+    this->timeToPair_ = latency;
+    this->pairing_ = false;
+  }
+}
+
+void ComfoFanEmulator::beginOperation(const Operation operation) {
+  // Until the bridge took a reply, repeated requests are retries of the same operation
+  if (!this->operationOpen_[operation]) {
+    this->operationOpen_[operation] = true;
+    this->operationStart_[operation] = millis();
+    ++this->stats_[operation].started;
+  }
+}
+
+void ComfoFanEmulator::dumpMetrics(void) {
+  ESP_LOGI(TAG, "Time to pair: %u ms", this->timeToPair_);
+
+  for (uint8_t i = 0; i < OperationCount; ++i) {
+    const OperationStats *stats = &this->stats_[i];
+
+    // Requests heard per confirmed operation, in hundredths: 1.00 means every first attempt got through
+    const uint32_t attempts =
+        (stats->confirmed > 0) ? (uint32_t) (((uint64_t) stats->requestFrames * 100) / stats->confirmed) : 0;
+
+    ESP_LOGI(TAG, "%-10s %u started, %u confirmed, latency avg %u max %u ms", operationNames[i], stats->started,
+             stats->confirmed, (stats->confirmed > 0) ? (stats->totalLatency / stats->confirmed) : 0,
+             stats->maxLatency);
+    ESP_LOGI(TAG, "%-10s latency p50 %u p90 %u p99 %u ms", "", percentile(this->latencies_[i], 50),
+             percentile(this->latencies_[i], 90), percentile(this->latencies_[i], 99));
+    ESP_LOGI(TAG, "%-10s %u requests (%u.%02u per confirmed), %u replies (%u dropped), airtime %u us/op", "",
+             stats->requestFrames, attempts / 100, attempts % 100, stats->replyFrames, stats->droppedReplies,
+             (stats->started > 0) ? (stats->airtime / stats->started) : 0);
+  }
+
+  ESP_LOGI(TAG, "Broadcasts: %u, ignored frames: %u", this->broadcastFrames_, this->ignoredFrames_);
+}
+
+void ComfoFanEmulator::resetMetrics(void) {
+  (void) memset(this->stats_, 0, sizeof(this->stats_));
+  (void) memset(this->operationOpen_, 0, sizeof(this->operationOpen_));
+  for (auto &latencies : this->latencies_) {
+    latencies.clear();
+  }
+  this->timeToPair_ = 0;
+  this->broadcastFrames_ = 0;
+  this->ignoredFrames_ = 0;
+}
+
+uint32_t ComfoFanEmulator::random(void) {
+  // xorshift32: seeded from the configuration, so runs repeat exactly
+  this->random_ ^= this->random_ << 13;
+  this->random_ ^= this->random_ >> 17;
+  this->random_ ^= this->random_ << 5;
+  return this->random_;
+}
+
+}  // namespace comfofan_emulator
+}  // namespace esphome
+
+#endif /* USE_HOST */
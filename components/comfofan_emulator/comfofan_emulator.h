@@ -0,0 +1,138 @@
+#ifndef __COMPONENT_COMFOFAN_EMULATOR_H__
+#define __COMPONENT_COMFOFAN_EMULATOR_H__
+
+#include "esphome/core/defines.h"
+
+#ifdef USE_HOST
+
+#include "esphome/core/component.h"
+#include "esphome/core/helpers.h"
+#include "esphome/components/nrf905/nRF905AirMedium.h"
+#include "esphome/components/zehnder/zehnder.h"
+
+#include <vector>
+
+namespace esphome {
+namespace comfofan_emulator {
+
+typedef enum {
+  OperationPair,        // 0x04 (link) -> 0x06, 0x04 -> 0x0B, 0x0B -> 0x0D
+  OperationQuery,       // 0x10 -> 0x07
+  OperationSetSpeed,    // 0x02/0x03 -> 0x05
+  OperationSetVoltage,  // 0x01 -> 0x1D
+  OperationCount
+} Operation;
+
+typedef struct {
+  uint32_t started;
+  uint32_t confirmed;
+  uint32_t totalLatency;   // ms, first request on air until the bridge radio took the reply
+  uint32_t maxLatency;     // ms
+  uint32_t requestFrames;  // Including retries
+  uint32_t replyFrames;    // Including duplicates
+  uint32_t droppedReplies;
+  uint32_t airtime;  // us, requests and replies
+} OperationStats;
+
+/* Software Zehnder/BUVA main unit, a node on the simulated air medium.
+ *
+ * It hears what the bridge's emulated radio puts on the air and answers the way the bridge expects from a fan:
+ * pairing, status queries and speed/timer/voltage commands. Replies can be delayed, dropped and repeated, and the
+ * unit can broadcast its settings unsolicited. Per-operation latency and airtime are kept for dumpMetrics(). */
+class ComfoFanEmulator : public Component, public nrf905::AirNode {
+ public:
+  void setup() override;
+  void loop() override;
+  void dump_config() override;
+  float get_setup_priority() const override { return setup_priority::DATA; }
+
+  void set_channel(const uint16_t channel) { channel_ = channel; }
+  void set_network_id(const uint32_t networkId) { networkId_ = networkId; }
+  void set_main_unit_id(const uint8_t id) { mainUnitId_ = id; }
+  void set_reply_delay(const uint32_t delay) { replyDelay_ = delay; }
+  void set_reply_jitter(const uint32_t jitter) { replyJitter_ = jitter; }
+  void set_drop_rate(const float rate) { dropRate_ = rate; }
+  void set_duplicates(const uint8_t duplicates) { duplicates_ = duplicates; }
+  void set_broadcast_interval(const uint32_t interval) { broadcastInterval_ = interval; }
+  void set_pairing(const bool pairing) { pairing_ = pairing; }
+  void set_seed(const uint32_t seed) { random_ = (seed != 0) ? seed : 1; }
+  void set_remote_id(const uint8_t id) { remoteId_ = id; }
+
+  // Change the speed at the unit itself, as a wall switch would; broadcasts the new settings
+  void setSpeed(const uint8_t speed, const uint8_t timer = 0);
+  // Another remote in the network changes the speed: its 0x02/0x03 and the unit's 0x05 go on air
+  void remoteSetSpeed(const uint8_t speed, const uint8_t timer = 0);
+  void setPairing(const bool pairing) { this->pairing_ = pairing; }
+
+  uint16_t airChannel(void) override { return this->channel_; }
+  bool airAddressMatch(const uint32_t address) override;
+  bool airReceive(const uint32_t address, const uint8_t *const pPayload, const uint8_t length) override;
+  void airCarrier(const bool carrier) override { this->carrier_ = carrier; }
+  void airTransmitted(const uint8_t receivers) override;
+
+  const OperationStats &getStats(const Operation operation) { return this->stats_[operation]; }
+  uint32_t getTimeToPair(void) { return this->timeToPair_; }
+  void dumpMetrics(void);
+  void resetMetrics(void);
+
+ protected:
+  typedef struct {
+    uint32_t start;  // us
+    uint32_t address;
+    zehnder::RfFrame frame;
+    Operation operation;  // OperationCount for unsolicited frames
+    bool confirms;        // Taking this frame completes the operation
+    bool onAir;
+  } Transmission;
+
+  void applySpeed(const uint8_t speed, const uint8_t timer = 0);
+  void handleFrame(const uint32_t address, const zehnder::RfFrame *const frame);
+  void makeReply(const zehnder::RfFrame *const request, const uint8_t command, zehnder::RfFrame *const reply);
+  void send(const uint32_t address, const zehnder::RfFrame *const frame, const Operation operation,
+            const bool confirms);
+  void queue(const uint32_t address, const zehnder::RfFrame *const frame, const Operation operation,
+             const bool confirms, const uint32_t delay);
+  void transmitted(const Transmission *const transmission, const bool taken);
+  void fillSettings(zehnder::RfFrame *const frame);
+  void broadcastSettings(void);
+  void beginOperation(const Operation operation);
+  uint32_t random(void);
+
+  uint16_t channel_{118};
+  uint32_t networkId_{0x89ABCDEF};
+  uint8_t mainUnitId_{0x42};
+  uint8_t remoteId_{0x77};  // The other remote, see remoteSetSpeed()
+  uint32_t replyDelay_{20};  // ms
+  uint32_t replyJitter_{0};  // ms, added uniformly on top of the delay
+  float dropRate_{0.0f};
+  uint8_t duplicates_{0};  // Extra copies of every reply
+  uint32_t broadcastInterval_{0};  // ms, 0 = never
+  bool pairing_{true};
+  uint32_t random_{1};
+
+  uint8_t speed_{zehnder::FAN_SPEED_LOW};
+  uint8_t voltage_{30};
+  uint8_t timer_{0};  // Minutes
+  uint32_t timerEnd_{0};
+  uint8_t timerRestoreSpeed_{zehnder::FAN_SPEED_LOW};
+
+  std::vector<Transmission> pending_;  // Front is on air once its onAir is set
+  bool carrier_{false};
+  uint32_t lastBroadcast_{0};
+  HighFrequencyLoopRequester highFreq_;
+
+  OperationStats stats_[OperationCount]{};
+  bool operationOpen_[OperationCount]{};
+  uint32_t operationStart_[OperationCount]{};
+  std::vector<uint32_t> latencies_[OperationCount];  // ms, of every confirmed operation
+  uint32_t timeToPair_{0};
+  uint32_t broadcastFrames_{0};
+  uint32_t ignoredFrames_{0};
+};
+
+}  // namespace comfofan_emulator
+}  // namespace esphome
+
+#endif /* USE_HOST */
+
+#endif /* __COMPONENT_COMFOFAN_EMULATOR_H__ */
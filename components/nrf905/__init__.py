@@ -1,42 +1,221 @@
 import esphome.codegen as cg
 import esphome.config_validation as cv
 from esphome import pins
-from esphome.components import fan, spi
-from esphome.const import CONF_ID
+from esphome.components import fan, sensor, spi
+from esphome.const import (
+    CONF_CHANNEL,
+    CONF_ID,
+    DEVICE_CLASS_DURATION,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    STATE_CLASS_TOTAL_INCREASING,
+    UNIT_MILLISECOND,
+    UNIT_SECOND,
+)
+from esphome.core import CORE
+
+AUTO_LOAD = ["sensor"]
 
+CONF_AIR_MEDIUM = "air_medium"
+CONF_AIRTIME = "airtime"
 CONF_AM_PIN = "am_pin"
+CONF_BUS_ID = "bus_id"
 CONF_CD_PIN = "cd_pin"
 CONF_CE_PIN = "ce_pin"
 CONF_DR_PIN = "dr_pin"
+CONF_EMULATOR_ID = "emulator_id"
+CONF_FRAMES_RECEIVED = "frames_received"
+CONF_IDLE_TIME = "idle_time"
+CONF_LISTEN_INTERVAL = "listen_interval"
+CONF_LISTEN_WINDOW = "listen_window"
+CONF_LISTEN_BEFORE_TALK = "listen_before_talk"
+CONF_PERSISTENT = "persistent"
+CONF_POWER_DOWN_TIME = "power_down_time"
+CONF_POWER_POLICY = "power_policy"
 CONF_PWR_PIN = "pwr_pin"
+CONF_RECEIVE_TIME = "receive_time"
+CONF_REGISTER_CHECK_INTERVAL = "register_check_interval"
+CONF_RX_INVALID = "rx_invalid"
+CONF_SEED = "seed"
+CONF_STATS_UPDATE_INTERVAL = "stats_update_interval"
+CONF_TRACE = "trace"
+CONF_TRAFFIC_INTERVAL = "traffic_interval"
+CONF_TRANSMISSIONS = "transmissions"
+CONF_TRANSMIT_TIME = "transmit_time"
+CONF_TX_READY = "tx_ready"
 CONF_TXEN_PIN = "txen_pin"
-
-DEPENDENCIES = ["spi"]
+CONF_VIRTUAL_NODES = "virtual_nodes"
 
 nrf905_ns = cg.esphome_ns.namespace("nrf905")
 nRF905Component = nrf905_ns.class_("nRF905", fan.FanState)
+nRF905SpiBus = nrf905_ns.class_("nRF905SpiBus", spi.SPIDevice)
+nRF905Emulator = nrf905_ns.class_("nRF905Emulator")
+PowerPolicy = nrf905_ns.enum("PowerPolicy")
+Mode = nrf905_ns.enum("Mode")
+
+POWER_POLICIES = {
+    "always_on": PowerPolicy.PowerAlwaysOn,
+    "reply_only": PowerPolicy.PowerReplyOnly,
+    "listen_windows": PowerPolicy.PowerListenWindows,
+}
+global_air_medium = nrf905_ns.global_air_medium
+
+# Time-in-mode sensors, by radio mode
+MODE_TIME_SENSORS = {
+    CONF_POWER_DOWN_TIME: Mode.PowerDown,
+    CONF_IDLE_TIME: Mode.Idle,
+    CONF_RECEIVE_TIME: Mode.Receive,
+    CONF_TRANSMIT_TIME: Mode.Transmit,
+}
+
+# Event count sensors, by setter
+COUNT_SENSORS = {
+    CONF_TRANSMISSIONS: "set_transmissions_sensor",
+    CONF_TX_READY: "set_tx_ready_sensor",
+    CONF_FRAMES_RECEIVED: "set_frames_received_sensor",
+    CONF_RX_INVALID: "set_rx_invalid_sensor",
+}
 
-CONFIG_SCHEMA = (
-    cv.Schema(
+MODE_TIME_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement=UNIT_SECOND,
+    accuracy_decimals=1,
+    device_class=DEVICE_CLASS_DURATION,
+    state_class=STATE_CLASS_TOTAL_INCREASING,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    icon="mdi:timer-outline",
+)
+
+COUNT_SCHEMA = sensor.sensor_schema(
+    accuracy_decimals=0,
+    state_class=STATE_CLASS_TOTAL_INCREASING,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    icon="mdi:counter",
+)
+
+BASE_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(nRF905Component),
+        cv.Optional(
+            CONF_REGISTER_CHECK_INTERVAL, default="5min"
+        ): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_TRACE, default=False): cv.boolean,
+        # What the radio does between transactions. reply_only and listen_windows save most of the receive current,
+        # but a powered down radio hears neither other remotes nor the unit's unsolicited settings: the fan state
+        # only catches up on the next poll. The zehnder fan refuses them unless its passive_tracking is off
+        cv.Optional(CONF_POWER_POLICY, default="always_on"): cv.enum(
+            POWER_POLICIES, lower=True
+        ),
+        cv.Optional(
+            CONF_LISTEN_INTERVAL, default="60s"
+        ): cv.positive_time_period_milliseconds,
+        cv.Optional(
+            CONF_LISTEN_WINDOW, default="1s"
+        ): cv.positive_time_period_milliseconds,
+        # Radio activity sensors, all published every stats_update_interval
+        cv.Optional(
+            CONF_STATS_UPDATE_INTERVAL, default="60s"
+        ): cv.positive_time_period_milliseconds,
+        **{cv.Optional(key): MODE_TIME_SCHEMA for key in MODE_TIME_SENSORS},
+        **{cv.Optional(key): COUNT_SCHEMA for key in COUNT_SENSORS},
+        cv.Optional(CONF_AIRTIME): sensor.sensor_schema(
+            unit_of_measurement=UNIT_MILLISECOND,
+            accuracy_decimals=0,
+            device_class=DEVICE_CLASS_DURATION,
+            state_class=STATE_CLASS_TOTAL_INCREASING,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            icon="mdi:radio-tower",
+        ),
+    }
+).extend(cv.COMPONENT_SCHEMA)
+
+# DEPENDENCIES can't depend on the platform: the radio needs an spi bus on hardware only
+HARDWARE_SCHEMA = cv.All(
+    BASE_SCHEMA.extend(
         {
-            cv.GenerateID(): cv.declare_id(nRF905Component),
+            cv.GenerateID(CONF_BUS_ID): cv.declare_id(nRF905SpiBus),
             cv.Optional(CONF_CD_PIN): pins.gpio_input_pin_schema,
             cv.Required(CONF_CE_PIN): pins.gpio_output_pin_schema,
             cv.Required(CONF_PWR_PIN): pins.gpio_output_pin_schema,
             cv.Required(CONF_TXEN_PIN): pins.gpio_output_pin_schema,
+            # On native GPIOs both make the status lines interrupt driven; on a port expander, or with only one
+            # of them wired, the status register is polled over SPI instead
             cv.Optional(CONF_AM_PIN): pins.gpio_input_pin_schema,
             cv.Optional(CONF_DR_PIN): pins.gpio_input_pin_schema,
         }
-    )
-    .extend(cv.COMPONENT_SCHEMA)
-    .extend(spi.spi_device_schema(cs_pin_required=True))
+    ).extend(spi.spi_device_schema(cs_pin_required=True)),
+    cv.requires_component("spi"),
 )
 
+# On the host platform the radio is an emulated chip, there is no SPI bus or pins to configure
+HOST_SCHEMA = BASE_SCHEMA.extend(
+    {
+        cv.GenerateID(CONF_EMULATOR_ID): cv.declare_id(nRF905Emulator),
+        # The simulated channel shared with the emulated main unit and other traffic
+        cv.Optional(CONF_AIR_MEDIUM, default={}): cv.Schema(
+            {
+                cv.Optional(CONF_CHANNEL, default=118): cv.int_range(min=0, max=511),
+                cv.Optional(CONF_VIRTUAL_NODES, default=0): cv.int_range(min=0, max=32),
+                cv.Optional(
+                    CONF_TRAFFIC_INTERVAL, default="10s"
+                ): cv.positive_time_period_milliseconds,
+                cv.Optional(CONF_LISTEN_BEFORE_TALK, default=True): cv.boolean,
+                cv.Optional(CONF_PERSISTENT, default=False): cv.boolean,
+                cv.Optional(CONF_SEED, default=1): cv.uint32_t,
+            }
+        ),
+    }
+)
+
+
+def CONFIG_SCHEMA(config):
+    if CORE.is_host:
+        return HOST_SCHEMA(config)
+    return HARDWARE_SCHEMA(config)
+
 
 async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
     await cg.register_component(var, config)
-    await spi.register_spi_device(var, config)
+
+    cg.add(
+        var.set_register_check_interval(config[CONF_REGISTER_CHECK_INTERVAL])
+    )
+
+    cg.add(var.set_power_policy(config[CONF_POWER_POLICY]))
+    cg.add(var.set_listen_interval(config[CONF_LISTEN_INTERVAL]))
+    cg.add(var.set_listen_window(config[CONF_LISTEN_WINDOW]))
+
+    cg.add(var.set_stats_interval(config[CONF_STATS_UPDATE_INTERVAL]))
+    for key, mode in MODE_TIME_SENSORS.items():
+        if key in config:
+            sens = await sensor.new_sensor(config[key])
+            cg.add(var.set_mode_time_sensor(mode, sens))
+    for key, setter in COUNT_SENSORS.items():
+        if key in config:
+            sens = await sensor.new_sensor(config[key])
+            cg.add(getattr(var, setter)(sens))
+    if CONF_AIRTIME in config:
+        sens = await sensor.new_sensor(config[CONF_AIRTIME])
+        cg.add(var.set_airtime_sensor(sens))
+
+    if config[CONF_TRACE]:
+        cg.add_define("USE_NRF905_TRACE")
+
+    if CORE.is_host:
+        emulator = cg.new_Pvariable(config[CONF_EMULATOR_ID])
+        cg.add(var.set_emulator(emulator))
+
+        air = config[CONF_AIR_MEDIUM]
+        cg.add(global_air_medium.set_channel(air[CONF_CHANNEL]))
+        cg.add(global_air_medium.set_virtual_nodes(air[CONF_VIRTUAL_NODES]))
+        cg.add(global_air_medium.set_traffic_interval(air[CONF_TRAFFIC_INTERVAL]))
+        cg.add(global_air_medium.set_listen_before_talk(air[CONF_LISTEN_BEFORE_TALK]))
+        cg.add(global_air_medium.set_persistent(air[CONF_PERSISTENT]))
+        cg.add(global_air_medium.set_seed(air[CONF_SEED]))
+        return
+
+    bus = cg.new_Pvariable(config[CONF_BUS_ID])
+    await spi.register_spi_device(bus, config)
+    cg.add(var.set_bus(bus))
 
     if CONF_AM_PIN in config:
         data = await cg.gpio_pin_expression(config[CONF_AM_PIN])
@@ -1,23 +1,44 @@
 #include "nRF905.h"
 #include "esphome/core/log.h"
+#ifdef USE_HOST
+#include "nRF905Emulator.h"
+#endif
 
 #include <string.h>
 
-#define CHECK_REG_WRITE true
-
 namespace esphome {
 namespace nrf905 {
 
 static const char *TAG = "nRF905";
 
+// Time comes from the HAL so the driver can run on a virtual clock
+using hal::micros;
+using hal::millis;
+
 nRF905::nRF905(void) {}
 
-void nRF905::setup() {
-  Config config;
+#ifdef USE_HOST
+void nRF905::set_emulator(nRF905Emulator *const emulator) {
+  this->set_bus(emulator);
+  this->set_cd_pin(emulator->getCdPin());
+  this->set_ce_pin(emulator->getCePin());
+  this->set_pwr_pin(emulator->getPwrPin());
+  this->set_txen_pin(emulator->getTxenPin());
+}
+#endif
+
+nRF905Transaction::nRF905Transaction(nRF905 *const pRf, const Mode finalMode) : rf_(pRf), finalMode_(finalMode) {
+  this->rf_->beginTransaction();
+}
 
+nRF905Transaction::nRF905Transaction(nRF905 *const pRf) : nRF905Transaction(pRf, pRf->getMode()) {}
+
+nRF905Transaction::~nRF905Transaction() { this->rf_->endTransaction(this->finalMode_); }
+
+void nRF905::setup() {
   ESP_LOGD(TAG, "Start nRF905 init");
 
-  this->spi_setup();
+  this->_bus->setup();
   if (this->_gpio_pin_am != NULL) {
     this->_gpio_pin_am->setup();
   }
@@ -29,15 +50,21 @@ void nRF905::setup() {
     this->_gpio_pin_dr->setup();
   }
   this->_gpio_pin_pwr->setup();
-  this->_gpio_pin_pwr->digital_write(false);
-  delay(100);  // Wait 100ms
-  this->_gpio_pin_pwr->digital_write(true);
-  delay(100);  // Wait for module to stabilize
   this->_gpio_pin_txen->setup();
 
-  this->setMode(PowerDown);
-
-  this->readConfigRegisters();
+  // With both DR and AM on interrupt capable pins the status lines are edge-triggered. Otherwise, port expander
+  // pins included, loop() polls the status register: it holds the same two bits.
+  if ((this->_gpio_pin_dr != NULL) && (this->_gpio_pin_am != NULL) && this->_gpio_pin_dr->is_internal() &&
+      this->_gpio_pin_am->is_internal()) {
+    InternalGPIOPin *const dr = static_cast<InternalGPIOPin *>(this->_gpio_pin_dr);
+    InternalGPIOPin *const am = static_cast<InternalGPIOPin *>(this->_gpio_pin_am);
+
+    this->_store.dr_pin = dr->to_isr();
+    this->_store.am_pin = am->to_isr();
+    dr->attach_interrupt(nRF905Store::gpio_intr, &this->_store, gpio::INTERRUPT_ANY_EDGE);
+    am->attach_interrupt(nRF905Store::gpio_intr, &this->_store, gpio::INTERRUPT_ANY_EDGE);
+    this->_useInterrupts = true;
+  }
 
   this->_config.band = true;
   this->_config.channel = 118;
@@ -63,20 +90,61 @@ void nRF905::setup() {
   this->_config.clkOutFrequency = ClkOut500000;
   this->_config.clkOutEnable = false;
 
-  // Write config back
-  this->writeConfigRegisters();
   this->writeTxAddress(0xA55A5AA5);
 
-  // Return to idle
-  this->setMode(Idle);
+  // PWR_UP low only selects power down, the registers survive and powerUp() rewrites them anyway: no need to hold
+  // it there. Go straight to standby and write the registers once the module got there, whatever was configured
+  // until then.
+  this->_gpio_pin_ce->digital_write(false);
+  this->_gpio_pin_txen->digital_write(false);
+  this->_gpio_pin_pwr->digital_write(true);
+  this->_pinsValid = true;
+  this->_residency[this->_mode] += micros() - this->_modeSince;
+  this->_modeSince = micros();
+  this->_mode = Idle;
+  this->_powerUpTime = millis();
+  this->set_timeout("power_cycle", NRF905_POWER_UP_TIME, [this]() { this->powerUp(); });
+
+  if (this->_registerCheckInterval > 0) {
+    this->set_interval("register_check", this->_registerCheckInterval, [this]() { this->registerCheck(); });
+  }
+  if (this->_powerPolicy == PowerListenWindows) {
+    this->set_interval("listen_interval", this->_listenInterval, [this]() { this->openListenWindow(); });
+  }
+  if (this->_statsInterval > 0) {
+    this->set_interval("publish_stats", this->_statsInterval, [this]() { this->publishStats(); });
+  }
 
-  ESP_LOGD(TAG, "nRF905 Setup complete");
+  ESP_LOGD(TAG, "nRF905 Setup complete, powering up");
+}
+
+void nRF905::powerUp(void) {
+  // Whatever was configured while powering up, the chip starts from its reset values
+  const Config config = this->_config;
+
+  this->_ready = true;
+
+  this->readConfigRegisters();
+  this->_config = config;
+  this->writeConfigRegisters();
+  if (this->_txAddressPending) {
+    this->_txAddressPending = false;
+    this->writeTxAddress(this->_txAddress);
+  }
+  if (this->_txPayloadPending) {
+    this->_txPayloadPending = false;
+    this->writeTxPayload(this->_shadowTxPayload, NRF905_MAX_FRAMESIZE);
+  }
+
+  this->setMode(this->_readyMode);
+
+  ESP_LOGD(TAG, "nRF905 powered up");
 }
 
 void nRF905::dump_config() {
   ESP_LOGCONFIG(TAG, "Config:");
 
-  LOG_PIN("  CS Pin:", this->cs_);
+  this->_bus->dumpConfig();
   if (this->_gpio_pin_am != NULL) {
     LOG_PIN("  AM Pin:", this->_gpio_pin_am);
   }
@@ -89,94 +157,192 @@ void nRF905::dump_config() {
   LOG_PIN("  CE Pin:", this->_gpio_pin_ce);
   LOG_PIN("  PWR Pin:", this->_gpio_pin_pwr);
   LOG_PIN("  TXEN Pin:", this->_gpio_pin_txen);
+  ESP_LOGCONFIG(TAG, "  Status: %s", this->_useInterrupts ? "DR/AM interrupts" : "SPI polling");
+  if (this->_registerCheckInterval > 0) {
+    ESP_LOGCONFIG(TAG, "  Register check interval: %u ms", this->_registerCheckInterval);
+  }
+  switch (this->_powerPolicy) {
+    case PowerAlwaysOn:
+      ESP_LOGCONFIG(TAG, "  Power policy: always on");
+      break;
+
+    case PowerReplyOnly:
+      ESP_LOGCONFIG(TAG, "  Power policy: reply only");
+      break;
+
+    case PowerListenWindows:
+      ESP_LOGCONFIG(TAG, "  Power policy: listen %u ms every %u ms", this->_listenWindow, this->_listenInterval);
+      break;
+  }
+  LOG_SENSOR("  ", "Power Down Time", this->_modeTimeSensors[PowerDown]);
+  LOG_SENSOR("  ", "Idle Time", this->_modeTimeSensors[Idle]);
+  LOG_SENSOR("  ", "Receive Time", this->_modeTimeSensors[Receive]);
+  LOG_SENSOR("  ", "Transmit Time", this->_modeTimeSensors[Transmit]);
+  LOG_SENSOR("  ", "Transmissions", this->_transmissionsSensor);
+  LOG_SENSOR("  ", "TX Ready", this->_txReadySensor);
+  LOG_SENSOR("  ", "Frames Received", this->_framesReceivedSensor);
+  LOG_SENSOR("  ", "RX Invalid", this->_rxInvalidSensor);
+  LOG_SENSOR("  ", "Airtime", this->_airtimeSensor);
+  ESP_LOGCONFIG(TAG, "  SPI: %u transfers, %u bytes (%u bytes avoided)", this->_counters.spiTransfers,
+                this->_counters.spiBytes, this->_counters.spiBytesSaved);
+  ESP_LOGCONFIG(TAG, "  GPIO: %u writes (%u writes avoided)", this->_counters.gpioWrites,
+                this->_counters.gpioWritesSaved);
+  ESP_LOGCONFIG(TAG, "  RX queue: %u/%u high-water, %u overflows", this->_rxQueue.highWaterMark(),
+                (unsigned) this->_rxQueue.capacity(), this->_rxQueue.overflows());
+}
+
+void IRAM_ATTR nRF905Store::gpio_intr(nRF905Store *arg) {
+  arg->eventTime = esphome::micros();  // ISR context, always the hardware clock
+  arg->events = arg->events + 1;
 }
 
 void nRF905::loop() {
-  static uint8_t lastState = 0x00;
-  static bool addrMatch;
-  uint8_t buffer[NRF905_MAX_FRAMESIZE];
+  uint8_t state;
 
-  uint8_t state = this->readStatus() & ((1 << NRF905_STATUS_DR) | (1 << NRF905_STATUS_AM));
-  if (lastState != state) {
-    ESP_LOGV(TAG, "State change: 0x%02X -> 0x%02X", lastState, state);
-    if (state == ((1 << NRF905_STATUS_DR) | (1 << NRF905_STATUS_AM))) {
-      addrMatch = false;
+  if (!this->_ready) {
+    return;
+  }
 
-      // Read data
-      this->readRxPayload(buffer, NRF905_MAX_FRAMESIZE);
-      ESP_LOGD(TAG, "RX Complete: %s", hexArrayToStr(buffer, NRF905_MAX_FRAMESIZE));
+  if (this->_useInterrupts) {
+    // Nothing happened on DR/AM since the last pass, leave the SPI bus alone
+    if (this->_store.events == this->_handledEvents) {
+      return;
+    }
+    this->_handledEvents = this->_store.events;
+    state = this->readStatusPins();
+  } else {
+    // Any SPI command since the last pass already returned the status register, no NOP needed then
+    if (this->_statusFresh) {
+      ++this->_counters.spiBytesSaved;
+    } else {
+      this->readStatus();
+    }
+    this->_statusFresh = false;
+    state = this->_status & ((1 << NRF905_STATUS_DR) | (1 << NRF905_STATUS_AM));
+  }
+
+  this->handleStatus(state);
+}
 
-      if (this->onRxComplete != NULL) {
-        this->onRxComplete(buffer, NRF905_MAX_FRAMESIZE);
+void nRF905::handleStatus(const uint8_t state) {
+  if (this->_lastState != state) {
+    ESP_LOGV(TAG, "State change: 0x%02X -> 0x%02X", this->_lastState, state);
+    if (state == ((1 << NRF905_STATUS_DR) | (1 << NRF905_STATUS_AM))) {
+      this->_addrMatch = false;
+
+      // Read exactly the configured payload width straight into the queue slot
+      RxFrame *frame = this->_rxQueue.acquire();
+      ++this->_stats.rxFrames;
+      if (frame != NULL) {
+        frame->time = millis();
+        frame->length = this->_config.rx_payload_width;
+        this->readRxPayload(frame->data, frame->length);
+        NRF905_TRACE(TraceRxFrame, 0, frame->data, frame->length);
+        ESP_LOGV(TAG, "RX Complete (%u bytes)", frame->length);
+        this->_rxQueue.commit();
+      } else {
+        // Still clock the payload out so DR clears and the next frame can be received
+        uint8_t discard[NRF905_MAX_FRAMESIZE];
+        this->readRxPayload(discard, this->_config.rx_payload_width);
+        NRF905_TRACE(TraceRxDropped, 0, discard, this->_config.rx_payload_width);
+        ESP_LOGW(TAG, "RX queue full, frame dropped");
       }
     } else if (state == (1 << NRF905_STATUS_DR)) {
-      addrMatch = false;
-
-      // ESP_LOGD(TAG, "TX Ready; retransmits: %u", this->retransmitCounter);
-      // if (this->retransmitCounter > 0) {
-      //   --this->retransmitCounter;
-      // } else {
-      this->setMode(this->nextMode);
-
-      if (this->onTxReady != NULL) {
-        this->onTxReady();
+      this->_addrMatch = false;
+
+      // DR marks the end of the first copy and auto retransmit has started the next one already. The chip finishes
+      // the copy in flight when TX is dropped, so hold TX until the middle of the last copy wanted.
+      if (this->txCopies > 2) {
+        this->set_timeout("tx_hold", ((((2 * this->txCopies) - 3) * this->getPacketTime() / 2) + 500) / 1000,
+                          [this]() { this->finishTx(); });
+      } else {
+        this->finishTx();
       }
-      // }
     } else if (state == (1 << NRF905_STATUS_AM)) {
-      addrMatch = true;
-      ESP_LOGD(TAG, "Addr match");
+      this->_addrMatch = true;
+      ++this->_stats.addrMatches;
+      NRF905_TRACE(TraceAddrMatch, 0);
+      ESP_LOGV(TAG, "Addr match");
 
       // if (onAddrMatch != NULL)
       //   onAddrMatch(this);
-    } else if (state == 0 && addrMatch) {
-      addrMatch = false;
+    } else if (state == 0 && this->_addrMatch) {
+      this->_addrMatch = false;
+      ++this->_stats.rxInvalid;
+      NRF905_TRACE(TraceRxInvalid, 0);
       ESP_LOGD(TAG, "Rx Invalid");
       // if (onRxInvalid != NULL)
       //   onRxInvalid(this);
     }
 
-    lastState = state;
+    this->_lastState = state;
   }
-
-  // _drPrev = _drNew;
 }
 
 void nRF905::setMode(const Mode mode) {
-  // Set power
-  switch (mode) {
-    case PowerDown:
-      this->_gpio_pin_pwr->digital_write(false);
-      break;
+  if (!this->_ready) {
+    this->_readyMode = mode;
+    return;
+  }
 
-    default:
-      this->_gpio_pin_pwr->digital_write(true);
-      break;
+  if (mode != this->_mode) {
+    const uint32_t now = micros();
+
+    NRF905_TRACE(TraceModeChange, mode);
+    this->_residency[this->_mode] += now - this->_modeSince;
+    this->_modeSince = now;
+    if (this->_mode == PowerDown) {
+      this->_powerUpTime = millis();
+    }
   }
 
+  // Set power
+  this->writePin(this->_gpio_pin_pwr, mode != PowerDown, this->_mode != PowerDown);
+
   // Set CE
-  switch (mode) {
-    case Receive:  // fall through
-    case Transmit:
-      this->_gpio_pin_ce->digital_write(true);
-      break;
+  this->writePin(this->_gpio_pin_ce, (mode == Receive) || (mode == Transmit),
+                 (this->_mode == Receive) || (this->_mode == Transmit));
 
-    default:
-      this->_gpio_pin_ce->digital_write(false);
-      break;
+  // Enable TX
+  this->writePin(this->_gpio_pin_txen, mode == Transmit, this->_mode == Transmit);
+
+  this->_mode = mode;
+  this->_pinsValid = true;
+}
+
+void nRF905::writePin(GPIOPin *const pin, const bool level, const bool current) {
+  if (this->_pinsValid && (level == current)) {
+    ++this->_counters.gpioWritesSaved;
+    return;
   }
 
-  // Enable TX
-  switch (mode) {
-    case Transmit:
-      this->_gpio_pin_txen->digital_write(true);
-      break;
+  pin->digital_write(level);
+  ++this->_counters.gpioWrites;
+}
 
-    default:
-      this->_gpio_pin_txen->digital_write(false);
-      break;
+Mode nRF905::beginAccess(void) {
+  Mode mode = this->_mode;
+
+  // Registers are accessible in standby and power down; inside a transaction the first access enters standby
+  if ((mode == Receive) || (mode == Transmit)) {
+    this->setMode(Idle);
   }
 
-  this->_mode = mode;
+  return mode;
+}
+
+void nRF905::endAccess(const Mode mode) {
+  if (this->_transactionDepth == 0) {
+    this->setMode(mode);
+  }
+}
+
+void nRF905::beginTransaction(void) { ++this->_transactionDepth; }
+
+void nRF905::endTransaction(const Mode mode) {
+  if ((this->_transactionDepth > 0) && (--this->_transactionDepth == 0)) {
+    this->setMode(mode);
+  }
 }
 
 void nRF905::updateConfig(Config *config, uint8_t *const pStatus) {
@@ -189,9 +355,7 @@ void nRF905::readConfigRegisters(uint8_t *const pStatus) {
   Mode mode;
   ConfigBuffer buffer;
 
-  // Set mode to idle
-  mode = this->_mode;
-  this->setMode(Idle);
+  mode = this->beginAccess();
 
   // Prepare data
   buffer.command = NRF905_COMMAND_R_CONFIG;
@@ -207,66 +371,155 @@ void nRF905::readConfigRegisters(uint8_t *const pStatus) {
   (void) memset(&this->_config, 0, sizeof(Config));
   this->decodeConfigRegisters(&buffer, &this->_config);
 
+  // The chip now holds exactly these bytes
+  (void) memcpy(this->_shadowConfig, buffer.data, NRF905_REGISTER_COUNT);
+  this->_shadowConfigValid = true;
+
   // Restore mode
-  this->setMode(mode);
+  this->endAccess(mode);
 }
 
 void nRF905::writeConfigRegisters(uint8_t *const pStatus) {
   Mode mode;
+  ConfigBuffer registers;
   ConfigBuffer buffer;
-#if CHECK_REG_WRITE
-  uint8_t writeData[NRF905_REGISTER_COUNT];
-#endif
+  uint8_t first = 0;
+  uint8_t last = NRF905_REGISTER_COUNT - 1;
+  uint8_t length;
 
-  mode = this->_mode;
-  this->setMode(Idle);
+  // powerUp() writes the config
+  if (!this->_ready) {
+    return;
+  }
+
+  this->encodeConfigRegisters(&this->_config, &registers);
+
+  // Narrow the write down to the bytes that differ from what the chip holds
+  if (this->_shadowConfigValid) {
+    while ((first < NRF905_REGISTER_COUNT) && (registers.data[first] == this->_shadowConfig[first])) {
+      ++first;
+    }
+    if (first == NRF905_REGISTER_COUNT) {
+      ESP_LOGVV(TAG, "Config unchanged, skipping write");
+      this->_counters.spiBytesSaved += sizeof(ConfigBuffer);
+      if (pStatus != NULL) {
+        *pStatus = this->_status;
+      }
+      return;
+    }
+    while (registers.data[last] == this->_shadowConfig[last]) {
+      --last;
+    }
+  }
+  length = (last - first) + 1;
+  this->_counters.spiBytesSaved += NRF905_REGISTER_COUNT - length;
+
+  mode = this->beginAccess();
 
   this->printConfig(&this->_config);
 
-  // Create data
-  buffer.command = NRF905_COMMAND_W_CONFIG;
-  this->encodeConfigRegisters(&this->_config, &buffer);
+  // W_CONFIG carries the first register byte to write in its lower nibble
+  buffer.command = NRF905_COMMAND_W_CONFIG | first;
+  (void) memcpy(buffer.data, &registers.data[first], length);
 
-  ESP_LOGV(TAG, "Write config data: %s", hexArrayToStr(buffer.data, NRF905_REGISTER_COUNT));
-#if CHECK_REG_WRITE
-  (void) memcpy(writeData, buffer.data, NRF905_REGISTER_COUNT);
+#if ESPHOME_LOG_LEVEL >= ESPHOME_LOG_LEVEL_VERBOSE
+  ESP_LOGV(TAG, "Write config data [%u..%u]: %s", first, last, hexArrayToStr(buffer.data, length));
 #endif
 
-  this->spiTransfer((uint8_t *) &buffer, sizeof(ConfigBuffer));
+  this->spiTransfer((uint8_t *) &buffer, length + 1);
 
-#if CHECK_REG_WRITE
-  // Check config write by reading config back and compare
-  {
-    ConfigBuffer bufferRead;
+  (void) memcpy(this->_shadowConfig, registers.data, NRF905_REGISTER_COUNT);
+  this->_shadowConfigValid = true;
 
-    bufferRead.command = NRF905_COMMAND_R_CONFIG;
-    (void) memset(bufferRead.data, 0, NRF905_REGISTER_COUNT);
+  if (pStatus != NULL) {
+    *pStatus = buffer.command;
+  }
 
-    this->spiTransfer((uint8_t *) &bufferRead, sizeof(ConfigBuffer));
-    if (memcmp((void *) writeData, (void *) bufferRead.data, NRF905_REGISTER_COUNT) != 0) {
-      ESP_LOGE(TAG, "Config write failed");
-    } else {
-      ESP_LOGV(TAG, "Write config OK");
-    }
+  // Restore mode
+  this->endAccess(mode);
+}
+
+bool nRF905::verifyRegisters(void) {
+  Mode mode;
+  ConfigBuffer configBuffer;
+  AddressBuffer addressBuffer;
+  bool configOk = true;
+  bool addressOk = true;
+
+  if (!this->_ready || (!this->_shadowConfigValid && !this->_shadowTxAddressValid)) {
+    return true;
   }
+
+  mode = this->beginAccess();
+
+  if (this->_shadowConfigValid) {
+    configBuffer.command = NRF905_COMMAND_R_CONFIG;
+    (void) memset(configBuffer.data, 0, NRF905_REGISTER_COUNT);
+    this->spiTransfer((uint8_t *) &configBuffer, sizeof(ConfigBuffer));
+
+    if (memcmp(configBuffer.data, this->_shadowConfig, NRF905_REGISTER_COUNT) != 0) {
+      ESP_LOGE(TAG, "Config registers lost");
+#if ESPHOME_LOG_LEVEL >= ESPHOME_LOG_LEVEL_VERBOSE
+      ESP_LOGV(TAG, "Config registers read back: %s", hexArrayToStr(configBuffer.data, NRF905_REGISTER_COUNT));
 #endif
+      this->_shadowConfigValid = false;
+      configOk = false;
+    }
+  }
 
-  if (pStatus != NULL) {
-    *pStatus = buffer.command;
+  if (this->_shadowTxAddressValid) {
+    addressBuffer.command = NRF905_COMMAND_R_TX_ADDRESS;
+    (void) memset(addressBuffer.address, 0, 4);
+    this->spiTransfer((uint8_t *) &addressBuffer, sizeof(AddressBuffer));
+
+    if ((((uint32_t) addressBuffer.address[3] << 24) | (addressBuffer.address[2] << 16) |
+         (addressBuffer.address[1] << 8) | addressBuffer.address[0]) != this->_shadowTxAddress) {
+      ESP_LOGE(TAG, "TX address lost");
+      this->_shadowTxAddressValid = false;
+      addressOk = false;
+    }
   }
 
-  // Restore mode
-  this->setMode(mode);
+  // Invalidated shadows force a full rewrite; a chip that lost its registers lost its payload as well
+  if (!configOk) {
+    this->writeConfigRegisters();
+    this->_shadowTxPayloadValid = false;
+  }
+  if (!addressOk) {
+    this->writeTxAddress(this->_shadowTxAddress);
+    this->_shadowTxPayloadValid = false;
+  }
+  if (configOk && addressOk) {
+    ESP_LOGV(TAG, "Register check OK");
+  }
+
+  this->endAccess(mode);
+
+  return configOk && addressOk;
 }
 
 void nRF905::writeTxAddress(const uint32_t txAddress, uint8_t *const pStatus) {
   Mode mode;
   AddressBuffer buffer;
 
+  if (!this->_ready) {
+    this->_txAddress = txAddress;
+    this->_txAddressPending = true;
+    return;
+  }
+
+  if (this->_shadowTxAddressValid && (this->_shadowTxAddress == txAddress)) {
+    ESP_LOGVV(TAG, "TX Address unchanged, skipping write");
+    this->_counters.spiBytesSaved += sizeof(AddressBuffer);
+    if (pStatus != NULL) {
+      *pStatus = this->_status;
+    }
+    return;
+  }
+
   ESP_LOGD(TAG, "Set TX Address: 0x%08X", txAddress);
 
-  mode = this->_mode;
-  this->setMode(Idle);
+  mode = this->beginAccess();
 
   buffer.command = NRF905_COMMAND_W_TX_ADDRESS;
   buffer.address[3] = (txAddress >> 24) & 0xFF;
@@ -275,21 +528,22 @@ void nRF905::writeTxAddress(const uint32_t txAddress, uint8_t *const pStatus) {
   buffer.address[0] = (txAddress) &0xFF;
 
   this->spiTransfer((uint8_t *) &buffer, sizeof(AddressBuffer));
+  this->_shadowTxAddress = txAddress;
+  this->_shadowTxAddressValid = true;
 
   if (pStatus != NULL) {
     *pStatus = buffer.command;
   }
 
   // Restore mode
-  this->setMode(mode);
+  this->endAccess(mode);
 }
 
 void nRF905::readTxAddress(uint32_t *pTxAddress, uint8_t *const pStatus) {
   Mode mode;
   AddressBuffer buffer;
 
-  mode = this->_mode;
-  this->setMode(Idle);
+  mode = this->beginAccess();
 
   buffer.command = NRF905_COMMAND_R_TX_ADDRESS;
   (void) memset(buffer.address, 0, 4);
@@ -302,12 +556,14 @@ void nRF905::readTxAddress(uint32_t *pTxAddress, uint8_t *const pStatus) {
   *pTxAddress |= (buffer.address[3] << 24);
 
   ESP_LOGD(TAG, "Got TX Address: 0x%08X", *pTxAddress);
+  this->_shadowTxAddress = *pTxAddress;
+  this->_shadowTxAddressValid = true;
 
   if (pStatus != NULL) {
     *pStatus = buffer.command;
   }
 
-  this->setMode(mode);
+  this->endAccess(mode);
 }
 
 void nRF905::readTxPayload(uint8_t *const pData, const uint8_t dataLength, uint8_t *const pStatus) {
@@ -326,8 +582,7 @@ void nRF905::readTxPayload(uint8_t *const pData, const uint8_t dataLength, uint8
   buffer.command = NRF905_COMMAND_R_TX_PAYLOAD;
   (void) memset(buffer.payload, 0, NRF905_MAX_FRAMESIZE);
 
-  mode = this->_mode;
-  this->setMode(Idle);
+  mode = this->beginAccess();
 
   this->spiTransfer((uint8_t *) &buffer, sizeof(Buffer));
   (void) memcpy(pData, buffer.payload, dataLength);
@@ -336,7 +591,7 @@ void nRF905::readTxPayload(uint8_t *const pData, const uint8_t dataLength, uint8
     *pStatus = buffer.command;
   }
 
-  this->setMode(mode);
+  this->endAccess(mode);
 }
 
 void nRF905::writeTxPayload(const uint8_t *const pData, const uint8_t dataLength, uint8_t *const pStatus) {
@@ -352,28 +607,44 @@ void nRF905::writeTxPayload(const uint8_t *const pData, const uint8_t dataLength
     return;
   }
 
-  ESP_LOGV(TAG, "Read config data: %s", hexArrayToStr(pData, dataLength));
-
   // Clear buffer payload
   (void) memset(buffer.payload, 0, NRF905_MAX_FRAMESIZE);
 
   buffer.command = NRF905_COMMAND_W_TX_PAYLOAD;
   (void) memcpy(buffer.payload, (uint8_t *) pData, dataLength);
 
-  mode = this->_mode;
-  this->setMode(Idle);
+  if (!this->_ready) {
+    (void) memcpy(this->_shadowTxPayload, buffer.payload, NRF905_MAX_FRAMESIZE);
+    this->_txPayloadPending = true;
+    return;
+  }
+
+  // Retries and repeated polls send the very same frame, the chip still holds it
+  if (this->_shadowTxPayloadValid && (memcmp(buffer.payload, this->_shadowTxPayload, NRF905_MAX_FRAMESIZE) == 0)) {
+    ESP_LOGVV(TAG, "TX payload unchanged, skipping write");
+    this->_counters.spiBytesSaved += sizeof(Buffer);
+    if (pStatus != NULL) {
+      *pStatus = this->_status;
+    }
+    return;
+  }
+
+  NRF905_TRACE(TraceTxPayload, 0, pData, dataLength);
+
+  mode = this->beginAccess();
+
+  (void) memcpy(this->_shadowTxPayload, buffer.payload, NRF905_MAX_FRAMESIZE);
+  this->_shadowTxPayloadValid = true;
 
   this->spiTransfer((uint8_t *) &buffer, sizeof(Buffer));
   if (pStatus != NULL) {
     *pStatus = buffer.command;
   }
 
-  this->setMode(mode);
+  this->endAccess(mode);
 }
 
 void nRF905::readRxPayload(uint8_t *const pData, const uint8_t dataLength, uint8_t *const pStatus) {
-  Buffer buffer;
-
   if (pData == NULL) {
     ESP_LOGE(TAG, "Read RX data pointer invalid");
     return;
@@ -383,16 +654,11 @@ void nRF905::readRxPayload(uint8_t *const pData, const uint8_t dataLength, uint8
     return;
   }
 
-  buffer.command = NRF905_COMMAND_R_RX_PAYLOAD;
-  (void) memset(buffer.payload, 0, NRF905_MAX_FRAMESIZE);
-
-  this->spiTransfer((uint8_t *) &buffer, sizeof(Buffer));
-
-  (void) memcpy(pData, buffer.payload, dataLength);
+  this->spiRead(NRF905_COMMAND_R_RX_PAYLOAD, pData, dataLength);
 
   // Return status if needed
   if (pStatus != NULL) {
-    *pStatus = buffer.command;
+    *pStatus = this->_status;
   }
 }
 
@@ -539,29 +805,56 @@ bool nRF905::airwayBusy(void) {
 
 void nRF905::startTx(const uint32_t retransmit, const Mode nextMode) {
   bool update = false;
+
+  this->wake();
   if (this->_mode == PowerDown) {
     this->setMode(Idle);
-    delay(3);  // Delay is needed to the radio has time to power-up and see the standby/TX pins pulse
   }
 
-  // Update counters
-  // this->retransmitCounter = retransmit;
+  // The radio needs time to reach standby before it sees the TX pins; start over once it is there
+  if (!this->_ready || ((millis() - this->_powerUpTime) < NRF905_POWER_UP_TIME)) {
+    this->set_timeout("tx_power_up", NRF905_POWER_UP_TIME, [this, retransmit, nextMode]() {
+      this->startTx(retransmit, nextMode);
+    });
+    return;
+  }
+
+  this->txCopies = getTxCopies(retransmit);
   this->nextMode = nextMode;
 
   // Set or clear retransmit flag
-  if ((this->_config.auto_retransmit == false) && (retransmit > 0)) {
+  if ((this->_config.auto_retransmit == false) && (this->txCopies > 1)) {
     this->_config.auto_retransmit = true;
     update = true;
-  } else if ((this->_config.auto_retransmit == true) && (retransmit == 0)) {
+  } else if ((this->_config.auto_retransmit == true) && (this->txCopies == 1)) {
     this->_config.auto_retransmit = false;
     update = true;
   }
-  if (update == true) {
-    this->writeConfigRegisters();
+
+  ++this->_stats.txStarted;
+  NRF905_TRACE(TraceTxStart, nextMode);
+
+  // Start transmit, straight from the config write if there is one
+  {
+    nRF905Transaction transaction(this, Transmit);
+    if (update == true) {
+      this->writeConfigRegisters();
+    }
   }
+  this->_highFreq.start();
+}
+
+void nRF905::finishTx(void) {
+  ++this->_stats.txReady;
+  this->_stats.airtime += this->getPacketTime() * this->txCopies;
 
-  // Start transmit
-  this->setMode(Transmit);
+  NRF905_TRACE(TraceTxReady, this->nextMode);
+  this->setMode(this->nextMode);
+  this->_highFreq.stop();
+
+  if (this->onTxReady != NULL) {
+    this->onTxReady();
+  }
 }
 
 uint8_t nRF905::readStatus(void) {
@@ -574,12 +867,177 @@ uint8_t nRF905::readStatus(void) {
   return status;
 }
 
+uint8_t nRF905::readStatusPins(void) {
+  uint8_t state = 0x00;
+
+  if (this->_store.dr_pin.digital_read()) {
+    state |= (1 << NRF905_STATUS_DR);
+  }
+  if (this->_store.am_pin.digital_read()) {
+    state |= (1 << NRF905_STATUS_AM);
+  }
+
+  return state;
+}
+
 void nRF905::spiTransfer(uint8_t *const data, const size_t length) {
-  this->enable();
+  // The chip clocks out its status register while receiving the command byte
+  data[0] = this->_bus->transfer(data[0], &data[1], length - 1);
+  this->_status = data[0];
+  this->_statusFresh = true;
+
+  ++this->_counters.spiTransfers;
+  this->_counters.spiBytes += length;
+}
+
+void nRF905::spiRead(const uint8_t command, uint8_t *const pData, const size_t length) {
+  this->_status = this->_bus->transfer(command, pData, length);
+  this->_statusFresh = true;
 
-  this->transfer_array(data, length);
+  ++this->_counters.spiTransfers;
+  this->_counters.spiBytes += length + 1;
+}
+
+void nRF905::sleep(void) {
+  this->_linkIdle = true;
+  if (this->_registerCheckDue) {
+    this->registerCheck();
+  }
 
-  this->disable();
+  if (this->_sleeping || (this->_powerPolicy == PowerAlwaysOn)) {
+    return;
+  }
+
+  this->_sleeping = true;
+  this->setMode(PowerDown);
+}
+
+void nRF905::wake(void) {
+  this->_linkIdle = false;
+  if (!this->_sleeping) {
+    return;
+  }
+
+  this->_sleeping = false;
+  this->cancel_timeout("listen_window");
+  if (this->_mode == PowerDown) {
+    this->setMode(Idle);
+  }
+}
+
+void nRF905::openListenWindow(void) {
+  // Only needed while sleeping, an awake radio is listening or busy anyway
+  if (!this->_sleeping) {
+    return;
+  }
+
+  // Receive straight from power down; the settling time comes out of the window
+  this->setMode(Receive);
+  this->set_timeout("listen_window", this->_listenWindow, [this]() { this->closeListenWindow(); });
+}
+
+void nRF905::closeListenWindow(void) {
+  if (!this->_sleeping) {
+    return;
+  }
+
+  // Don't cut off a frame that is coming in or waiting to be read
+  if (this->_addrMatch || (this->_lastState != 0)) {
+    this->set_timeout("listen_window", NRF905_LISTEN_EXTEND, [this]() { this->closeListenWindow(); });
+    return;
+  }
+
+  this->setMode(PowerDown);
+}
+
+void nRF905::registerCheck(void) {
+  // Register access drops the radio to standby: never in the middle of a transmission, a frame coming in or an
+  // exchange the protocol is still waiting on. Catch up once the link goes idle.
+  if ((this->_mode == Transmit) || (this->_transactionDepth > 0) || !this->_linkIdle || this->_addrMatch ||
+      (this->_lastState != 0)) {
+    this->_registerCheckDue = true;
+    return;
+  }
+
+  this->_registerCheckDue = false;
+  this->verifyRegisters();
+}
+
+uint32_t nRF905::getPacketTime(void) {
+  const uint8_t crcBytes = this->_config.crc_enable ? (this->_config.crc_bits / 8) : 0;
+
+  return (NRF905_PREAMBLE_BITS +
+          ((this->_config.tx_address_width + this->_config.tx_payload_width + crcBytes) * 8)) *
+         NRF905_BIT_TIME;
+}
+
+void nRF905::publishStats(void) {
+  for (uint8_t mode = 0; mode < NRF905_MODE_COUNT; ++mode) {
+    if (this->_modeTimeSensors[mode] != NULL) {
+      this->_modeTimeSensors[mode]->publish_state(this->getResidency((Mode) mode) / 1000000.0f);
+    }
+  }
+  if (this->_transmissionsSensor != NULL) {
+    this->_transmissionsSensor->publish_state(this->_stats.txStarted);
+  }
+  if (this->_txReadySensor != NULL) {
+    this->_txReadySensor->publish_state(this->_stats.txReady);
+  }
+  if (this->_framesReceivedSensor != NULL) {
+    this->_framesReceivedSensor->publish_state(this->_stats.rxFrames);
+  }
+  if (this->_rxInvalidSensor != NULL) {
+    this->_rxInvalidSensor->publish_state(this->_stats.rxInvalid);
+  }
+  if (this->_airtimeSensor != NULL) {
+    this->_airtimeSensor->publish_state(this->_stats.airtime / 1000.0f);
+  }
+}
+
+uint64_t nRF905::getResidency(const Mode mode) {
+  uint64_t residency = this->_residency[mode];
+
+  if (mode == this->_mode) {
+    residency += micros() - this->_modeSince;
+  }
+
+  return residency;
+}
+
+void nRF905::dumpResidency(void) {
+  static const char *const modeNames[NRF905_MODE_COUNT] = {"PowerDown", "Idle", "Receive", "Transmit"};
+  static const float modeCurrent[NRF905_MODE_COUNT] = {NRF905_CURRENT_POWER_DOWN, NRF905_CURRENT_STANDBY,
+                                                       NRF905_CURRENT_RECEIVE, NRF905_CURRENT_TRANSMIT};
+  uint64_t residency[NRF905_MODE_COUNT];
+  uint64_t total = 0;
+  float charge = 0.0f;
+
+  for (uint8_t mode = 0; mode < NRF905_MODE_COUNT; ++mode) {
+    residency[mode] = this->getResidency((Mode) mode);
+    total += residency[mode];
+    charge += residency[mode] * modeCurrent[mode];
+  }
+  if (total == 0) {
+    return;
+  }
+
+  ESP_LOGI(TAG, "Mode residency over %u s:", (uint32_t) (total / 1000000));
+  for (uint8_t mode = 0; mode < NRF905_MODE_COUNT; ++mode) {
+    ESP_LOGI(TAG, "  %-9s %10u ms %6.2f%%", modeNames[mode], (uint32_t) (residency[mode] / 1000),
+             (residency[mode] * 100.0f) / total);
+  }
+  ESP_LOGI(TAG, "  Average radio current: %.1f uA", charge / total);
+  ESP_LOGI(TAG, "  %u transmissions (%u ready), %u ms on air; %u frames received, %u address matches, %u invalid",
+           this->_stats.txStarted, this->_stats.txReady, (uint32_t) (this->_stats.airtime / 1000),
+           this->_stats.rxFrames, this->_stats.addrMatches, this->_stats.rxInvalid);
+}
+
+void nRF905::dumpTrace(void) {
+#ifdef NRF905_TRACE_BUFFER
+  global_trace.dump();
+#else
+  ESP_LOGW(TAG, "Tracing is not enabled");
+#endif
 }
 
 char *nRF905::hexArrayToStr(const uint8_t *const pData, const size_t dataLength) {
@@ -2,10 +2,14 @@
 #define __COMPONENT_nRF905_H__
 
 #include "esphome/core/component.h"
+#include "esphome/core/gpio.h"
 #include "esphome/core/hal.h"
 #include "esphome/core/helpers.h"
-#include "esphome/components/spi/spi.h"
+#include "esphome/components/sensor/sensor.h"
 #include "nRF905.h"
+#include "nRF905Hal.h"
+#include "nRF905RxQueue.h"
+#include "nRF905Trace.h"
 
 namespace esphome {
 namespace nrf905 {
@@ -16,6 +20,17 @@ namespace nrf905 {
 /* nRF905 register sizes */
 #define NRF905_REGISTER_COUNT 10
 #define NRF905_MAX_FRAMESIZE 32
+#define NRF905_RX_QUEUE_SIZE 8  // Received frames buffered until the consumer drains them (power of two)
+#define NRF905_POWER_UP_TIME 3       // ms, power down to standby
+#define NRF905_LISTEN_EXTEND 10      // ms, a listen window stays open this much longer while a frame comes in
+#define NRF905_BIT_TIME 20           // us per bit: 100 kbps Manchester coded, 50 kbps effective
+#define NRF905_PREAMBLE_BITS 10
+
+// Typical supply current per mode (datasheet, 868 MHz, +10 dBm), used to estimate the average draw
+#define NRF905_CURRENT_POWER_DOWN 2.5f  // uA
+#define NRF905_CURRENT_STANDBY 32.0f    // uA
+#define NRF905_CURRENT_RECEIVE 12500.0f  // uA
+#define NRF905_CURRENT_TRANSMIT 30000.0f  // uA
 
 /* nRF905 Instructions */
 #define NRF905_COMMAND_NOP 0xFF
@@ -38,6 +53,23 @@ typedef enum {
 } nRF905Cc;
 
 typedef enum { PowerDown, Idle, Receive, Transmit } Mode;
+#define NRF905_MODE_COUNT 4
+
+typedef struct {
+  uint32_t txStarted;    // Transmissions started
+  uint32_t txReady;      // Transmissions finished (DR in transmit mode)
+  uint32_t rxFrames;     // Valid frames received
+  uint32_t addrMatches;  // Address matches, valid or not
+  uint32_t rxInvalid;    // Address matches that ended without valid data (CRC error)
+  uint64_t airtime;      // us on air, computed from the packet length
+} RadioStats;
+
+/* What the radio does while the protocol has nothing outstanding, see nRF905::sleep() */
+typedef enum {
+  PowerAlwaysOn,       // Stay in whatever mode the last transaction left
+  PowerReplyOnly,      // Power down, only listen while a reply is expected
+  PowerListenWindows,  // Power down, but listen for a window every listen interval
+} PowerPolicy;
 
 typedef enum {
   ClkOut4000000 = 0x00,
@@ -83,31 +115,68 @@ typedef struct {
   uint8_t payload[NRF905_MAX_FRAMESIZE];
 } Buffer;
 
+/* DR/AM line edges captured by the interrupt handler */
+struct nRF905Store {
+  ISRInternalGPIOPin dr_pin;
+  ISRInternalGPIOPin am_pin;
+  volatile uint32_t events{0};      // Incremented on every DR/AM edge
+  volatile uint32_t eventTime{0};   // micros() timestamp of the last edge
+
+  static void gpio_intr(nRF905Store *arg);
+};
+
+/* Bus traffic counters; the *Saved fields count what the caching layers avoided */
+typedef struct {
+  uint32_t spiTransfers;
+  uint32_t spiBytes;
+  uint32_t spiBytesSaved;
+  uint32_t gpioWrites;
+  uint32_t gpioWritesSaved;
+} Counters;
+
 typedef std::function<void(void)> TxReadyCalllback;
-typedef std::function<void(const uint8_t *const pBuffer, const uint8_t size)> RxCompleteCallback;
 
-class nRF905 : public Component,
-               public spi::SPIDevice<spi::BIT_ORDER_MSB_FIRST, spi::CLOCK_POLARITY_LOW, spi::CLOCK_PHASE_LEADING,
-                                     spi::DATA_RATE_1MHZ> {
+#ifdef USE_HOST
+class nRF905Emulator;
+#endif
+
+class nRF905 : public Component {
  public:
   nRF905();
 
   void setup() override;
 
-  // float get_setup_priority() const override { return setup_priority::HARDWARE; }
-  float get_setup_priority() const override { return setup_priority::AFTER_CONNECTION; }
+  // Nothing here needs the network; up before the protocol components that use it
+  float get_setup_priority() const override { return setup_priority::HARDWARE; }
 
   void dump_config() override;
   void loop() override;
 
+  void set_bus(nRF905Bus *const bus) { _bus = bus; }
+#ifdef USE_HOST
+  // Run on an emulated chip: takes its SPI bus and GPIO lines
+  void set_emulator(nRF905Emulator *const emulator);
+#endif
   void set_am_pin(GPIOPin *const pin) { _gpio_pin_am = pin; }
   void set_cd_pin(GPIOPin *const pin) { _gpio_pin_cd = pin; }
   void set_ce_pin(GPIOPin *const pin) { _gpio_pin_ce = pin; }
   void set_dr_pin(GPIOPin *const pin) { _gpio_pin_dr = pin; }
   void set_pwr_pin(GPIOPin *const pin) { _gpio_pin_pwr = pin; }
   void set_txen_pin(GPIOPin *const pin) { _gpio_pin_txen = pin; }
-
-  void setOnRxComplete(RxCompleteCallback callback) { onRxComplete = callback; }
+  void set_register_check_interval(const uint32_t interval) { _registerCheckInterval = interval; }
+  void set_power_policy(const PowerPolicy policy) { _powerPolicy = policy; }
+  void set_listen_interval(const uint32_t interval) { _listenInterval = interval; }
+  void set_listen_window(const uint32_t window) { _listenWindow = window; }
+  void set_stats_interval(const uint32_t interval) { _statsInterval = interval; }
+  void set_mode_time_sensor(const Mode mode, sensor::Sensor *const sensor) { _modeTimeSensors[mode] = sensor; }
+  void set_transmissions_sensor(sensor::Sensor *const sensor) { _transmissionsSensor = sensor; }
+  void set_tx_ready_sensor(sensor::Sensor *const sensor) { _txReadySensor = sensor; }
+  void set_frames_received_sensor(sensor::Sensor *const sensor) { _framesReceivedSensor = sensor; }
+  void set_rx_invalid_sensor(sensor::Sensor *const sensor) { _rxInvalidSensor = sensor; }
+  void set_airtime_sensor(sensor::Sensor *const sensor) { _airtimeSensor = sensor; }
+
+  // Received frames. The queue is single consumer: exactly one component drains it, from its own loop().
+  RxQueue<NRF905_RX_QUEUE_SIZE> &getRxQueue(void) { return this->_rxQueue; }
   void setOnTxReady(TxReadyCalllback callback) { onTxReady = callback; }
 
   Mode getMode(void) { return this->_mode; };
@@ -122,33 +191,87 @@ class nRF905 : public Component,
   void writeTxPayload(const uint8_t *const pData, const uint8_t dataLength, uint8_t *const pStatus = NULL);
   void readTxPayload(uint8_t *const pData, const uint8_t dataLength, uint8_t *const pStatus = NULL);
 
+  // Read config and TX address back and compare against the shadow copy, rewrites everything on mismatch
+  bool verifyRegisters(void);
+
   bool airwayBusy(void);
 
+  // Status register as returned by the last SPI command
+  uint8_t getStatus(void) { return this->_status; }
+  const Counters &getCounters(void) { return this->_counters; }
+
+  // Use nRF905Transaction rather than calling these directly
+  void beginTransaction(void);
+  void endTransaction(const Mode mode);
+
+  // Timestamp (micros) of the last DR/AM edge; only maintained when both pins are wired
+  uint32_t getLastEventTime(void) { return this->_store.eventTime; }
+
+  // Send the TX payload retransmit times (once for 0), then go to nextMode and call the TX ready callback
   void startTx(const uint32_t retransmit, const Mode nextMode);
 
+  // Power cycle done and registers written; until then writes are kept and applied on power up
+  bool isReady(void) { return this->_ready; }
+
+  // The protocol has nothing outstanding: rest according to the power policy until wake() or startTx()
+  void sleep(void);
+  // Activity is coming up: leave power down now, so the radio has settled by the time it is needed
+  void wake(void);
+  // Time spent in a mode since boot, us
+  uint64_t getResidency(const Mode mode);
+  // Log time per mode and the average supply current it works out to
+  void dumpResidency(void);
+  const RadioStats &getStats(void) { return this->_stats; }
+  // On-air time of one packet with the current config, us
+  uint32_t getPacketTime(void);
+  // Copies of the payload a startTx() with the given retransmit count puts on air
+  static uint32_t getTxCopies(const uint32_t retransmit) { return (retransmit > 1) ? retransmit : 1; }
+  // On-air time of a startTx() with the given retransmit count, us
+  uint32_t getTxTime(const uint32_t retransmit) { return this->getPacketTime() * getTxCopies(retransmit); }
+
   void printConfig(const Config *const pConfig);
 
+  // Log the binary trace buffer (if tracing is compiled in)
+  void dumpTrace(void);
+
  protected:
   void readRxPayload(uint8_t *const pData, const uint8_t dataLength, uint8_t *const pStatus = NULL);
 
+  void powerUp(void);
+  void openListenWindow(void);
+  void closeListenWindow(void);
+  void registerCheck(void);
+  void publishStats(void);
   void readConfigRegisters(uint8_t *const pStatus = NULL);
   void writeConfigRegisters(uint8_t *const pStatus = NULL);
 
   void decodeConfigRegisters(const ConfigBuffer *const pBuffer, Config *const pConfig);
   void encodeConfigRegisters(const Config *const pConfig, ConfigBuffer *const pBuffer);
 
+  Mode beginAccess(void);
+  void endAccess(const Mode mode);
+  void writePin(GPIOPin *const pin, const bool level, const bool current);
+
   uint8_t readStatus(void);
+  uint8_t readStatusPins(void);
+  void handleStatus(const uint8_t state);
+  // The last copy is on air: leave TX for nextMode
+  void finishTx(void);
 
   void spiTransfer(uint8_t *const data, const size_t length);
+  // Send command, then read length bytes directly into pData
+  void spiRead(const uint8_t command, uint8_t *const pData, const size_t length);
 
   char *hexArrayToStr(const uint8_t *const pData, const size_t dataLength);
 
-  RxCompleteCallback onRxComplete{NULL};
+  RxQueue<NRF905_RX_QUEUE_SIZE> _rxQueue;
 
-  uint32_t retransmitCounter{0};
+  uint32_t txCopies{1};  // Copies of the payload the current transmit puts on air
   Mode nextMode{PowerDown};
   TxReadyCalllback onTxReady{NULL};
 
+  nRF905Bus *_bus{NULL};
+
   GPIOPin *_gpio_pin_am{NULL};
   GPIOPin *_gpio_pin_cd{NULL};
   GPIOPin *_gpio_pin_ce{NULL};
@@ -157,10 +280,74 @@ class nRF905 : public Component,
   GPIOPin *_gpio_pin_txen{NULL};
 
   Mode _mode{PowerDown};
+  uint32_t _modeSince{0};  // us
+  uint64_t _residency[NRF905_MODE_COUNT]{};  // us, completed spans per mode
+  uint32_t _powerUpTime{0};  // ms, last power down to standby transition
+  bool _ready{false};
+  Mode _readyMode{Idle};  // Mode to enter once power up completes
+  uint32_t _txAddress{0};
+  bool _txAddressPending{false};
+  bool _txPayloadPending{false};
+  bool _pinsValid{false};
+  uint8_t _transactionDepth{0};
+
+  uint8_t _status{0x00};
+  bool _statusFresh{false};
+  Counters _counters{};
+
+  // Shadow copy of what the chip holds, so unchanged registers are never rewritten
+  uint8_t _shadowConfig[NRF905_REGISTER_COUNT];
+  bool _shadowConfigValid{false};
+  uint32_t _shadowTxAddress{0};
+  bool _shadowTxAddressValid{false};
+  uint8_t _shadowTxPayload[NRF905_MAX_FRAMESIZE];
+  bool _shadowTxPayloadValid{false};
+  uint32_t _registerCheckInterval{0};
+  bool _registerCheckDue{false};  // Skipped while the link was busy, run once it goes idle
+
+  PowerPolicy _powerPolicy{PowerAlwaysOn};
+  uint32_t _listenInterval{60000};  // ms
+  uint32_t _listenWindow{1000};     // ms
+  bool _sleeping{false};
+  bool _linkIdle{true};  // Between sleep() and the next wake(): no TX pending, no reply awaited
+
+  RadioStats _stats{};
+  uint32_t _statsInterval{60000};  // ms
+  sensor::Sensor *_modeTimeSensors[NRF905_MODE_COUNT]{};
+  sensor::Sensor *_transmissionsSensor{NULL};
+  sensor::Sensor *_txReadySensor{NULL};
+  sensor::Sensor *_framesReceivedSensor{NULL};
+  sensor::Sensor *_rxInvalidSensor{NULL};
+  sensor::Sensor *_airtimeSensor{NULL};
+
+  // Edge-triggered status tracking, used instead of SPI polling when DR and AM are wired
+  bool _useInterrupts{false};
+  nRF905Store _store;
+  uint32_t _handledEvents{0};
+  uint8_t _lastState{0x00};
+  bool _addrMatch{false};
+
+  // Run loop() back-to-back while a transmission is in flight for a fast TX -> RX turnaround
+  HighFrequencyLoopRequester _highFreq;
 
   Config _config;
 };
 
+/* Batches register accesses: the radio enters standby on the first access only and is set to finalMode once,
+ * when the scope ends. Without a final mode the mode at construction is restored. */
+class nRF905Transaction {
+ public:
+  nRF905Transaction(nRF905 *const pRf, const Mode finalMode);
+  explicit nRF905Transaction(nRF905 *const pRf);
+  ~nRF905Transaction();
+
+  void setFinalMode(const Mode mode) { this->finalMode_ = mode; }
+
+ protected:
+  nRF905 *rf_;
+  Mode finalMode_;
+};
+
 }  // namespace nrf905
 }  // namespace esphome
 
@@ -0,0 +1,267 @@
+#include "nRF905AirMedium.h"
+
+#ifdef USE_HOST
+
+#include "nRF905Hal.h"
+#include "esphome/core/log.h"
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+namespace esphome {
+namespace nrf905 {
+
+static const char *TAG = "nRF905.air";
+
+#define NRF905_AIR_PACKET_HISTORY 100000  // us a finished packet is kept around for overlap checks
+
+AirMedium global_air_medium;
+
+uint32_t AirMedium::packetTime(const uint8_t addressWidth, const uint8_t payloadWidth, const uint8_t crcBytes) {
+  return (NRF905_AIR_PREAMBLE_BITS + ((addressWidth + payloadWidth + crcBytes) * 8)) * NRF905_AIR_BIT_TIME;
+}
+
+void AirMedium::attach(AirNode *const node) {
+  this->_nodes.push_back(node);
+  this->_carriers.push_back(false);
+}
+
+void AirMedium::transmit(AirNode *const from, const uint32_t start, const uint32_t end, const uint32_t address,
+                         const uint8_t *const pPayload, const uint8_t length) {
+  Packet packet;
+
+  packet.from = from;
+  packet.channel = from->airChannel();
+  packet.start = start;
+  packet.end = end;
+  packet.address = address;
+  packet.length = std::min(length, (uint8_t) NRF905_AIR_MAX_FRAMESIZE);
+  (void) memcpy(packet.payload, pPayload, packet.length);
+  packet.done = false;
+
+  this->_packets.push_back(packet);
+  ++this->_stats.transmissions;
+  this->_stats.airtime += end - start;
+}
+
+bool AirMedium::carrier(AirNode *const node, const uint32_t time) {
+  const uint16_t channel = node->airChannel();
+
+  for (const Packet &packet : this->_packets) {
+    if ((packet.from != node) && (packet.channel == channel) &&
+        ((int32_t) (time - (packet.start + NRF905_AIR_CD_DELAY)) >= 0) && ((int32_t) (time - packet.end) < 0)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+uint32_t AirMedium::busyUntil(AirNode *const node, const uint32_t time) {
+  const uint16_t channel = node->airChannel();
+  uint32_t until = time;
+
+  for (const Packet &packet : this->_packets) {
+    if ((packet.from != node) && (packet.channel == channel) && ((int32_t) (time - packet.start) >= 0) &&
+        ((int32_t) (packet.end - until) > 0)) {
+      until = packet.end;
+    }
+  }
+
+  return until;
+}
+
+void AirMedium::update(void) {
+  uint32_t now;
+
+  // Deliveries call back into the emulated radios, which update the medium themselves
+  if (this->_updating) {
+    return;
+  }
+  this->_updating = true;
+
+  now = hal::micros();
+  if (!this->_started) {
+    this->startVirtualNodes(now);
+  }
+
+  // Process the virtual node transmissions and packet ends up to now, oldest first
+  while (true) {
+    VirtualNode *node = nullptr;
+    size_t index = this->_packets.size();
+
+    for (VirtualNode *candidate : this->_virtualNodes) {
+      if (((int32_t) (now - candidate->nextTx_) >= 0) &&
+          ((node == nullptr) || ((int32_t) (candidate->nextTx_ - node->nextTx_) < 0))) {
+        node = candidate;
+      }
+    }
+    for (size_t i = 0; i < this->_packets.size(); ++i) {
+      const Packet &packet = this->_packets[i];
+      if (!packet.done && ((int32_t) (now - packet.end) >= 0) &&
+          ((index == this->_packets.size()) || ((int32_t) (packet.end - this->_packets[index].end) < 0))) {
+        index = i;
+      }
+    }
+
+    if ((node != nullptr) &&
+        ((index == this->_packets.size()) || ((int32_t) (node->nextTx_ - this->_packets[index].end) <= 0))) {
+      this->virtualTransmit(node, node->nextTx_);
+    } else if (index < this->_packets.size()) {
+      this->deliver(index);
+    } else {
+      break;
+    }
+  }
+
+  for (size_t i = 0; i < this->_nodes.size(); ++i) {
+    const bool carrier = this->carrier(this->_nodes[i], now);
+    if (carrier != this->_carriers[i]) {
+      this->_carriers[i] = carrier;
+      this->_nodes[i]->airCarrier(carrier);
+    }
+  }
+
+  this->_packets.erase(std::remove_if(this->_packets.begin(), this->_packets.end(),
+                                      [now](const Packet &packet) {
+                                        return packet.done &&
+                                               ((int32_t) (now - packet.end) > NRF905_AIR_PACKET_HISTORY);
+                                      }),
+                       this->_packets.end());
+
+  this->_updating = false;
+}
+
+void AirMedium::startVirtualNodes(const uint32_t now) {
+  this->_started = true;
+  this->_startTime = now;
+
+  for (uint8_t i = 0; i < this->_virtualNodeCount; ++i) {
+    VirtualNode *node = new VirtualNode(this, 0x56000000 | i);  // NOLINT
+    node->nextTx_ = now + this->nextInterval();
+    this->_virtualNodes.push_back(node);
+    this->attach(node);
+  }
+}
+
+void AirMedium::virtualTransmit(VirtualNode *const node, const uint32_t time) {
+  const uint32_t duration = packetTime(4, 16, 2);
+  uint8_t payload[16];
+  uint32_t target;
+
+  if (this->_listenBeforeTalk && this->carrier(node, time)) {
+    ++this->_stats.deferrals;
+    if (this->_persistent) {
+      node->nextTx_ = this->busyUntil(node, time);
+    } else {
+      node->nextTx_ = time + 1 + (this->random() % NRF905_AIR_BACKOFF_MAX);
+    }
+    return;
+  }
+
+  for (uint8_t i = 0; i < sizeof(payload); ++i) {
+    payload[i] = (uint8_t) this->random();
+  }
+  // Any other virtual node; a lone node talks to nobody
+  target = node->address_;
+  if (this->_virtualNodes.size() > 1) {
+    while (target == node->address_) {
+      target = this->_virtualNodes[this->random() % this->_virtualNodes.size()]->address_;
+    }
+  }
+
+  this->transmit(node, time, time + duration, target, payload, sizeof(payload));
+  node->busyUntil_ = time + duration;
+  node->nextTx_ = time + duration + this->nextInterval();
+  ++node->sent_;
+}
+
+bool AirMedium::VirtualNode::airReceive(const uint32_t address, const uint8_t *const pPayload, const uint8_t length) {
+  // Half duplex
+  if ((int32_t) (hal::micros() - this->busyUntil_) < 0) {
+    return false;
+  }
+
+  ++this->received_;
+  return true;
+}
+
+void AirMedium::deliver(const size_t index) {
+  // Receivers may queue new packets, work on a copy
+  const Packet packet = this->_packets[index];
+  bool collided = false;
+  uint8_t receivers = 0;
+
+  this->_packets[index].done = true;
+
+  for (size_t i = 0; i < this->_packets.size(); ++i) {
+    const Packet &other = this->_packets[i];
+    if ((i != index) && (other.channel == packet.channel) && ((int32_t) (other.start - packet.end) < 0) &&
+        ((int32_t) (other.end - packet.start) > 0)) {
+      collided = true;
+      break;
+    }
+  }
+
+  for (size_t i = 0; i < this->_nodes.size(); ++i) {
+    AirNode *node = this->_nodes[i];
+
+    if ((node == packet.from) || (node->airChannel() != packet.channel) || !node->airAddressMatch(packet.address)) {
+      continue;
+    }
+
+    ++this->_stats.receptions;
+    if (collided) {
+      ++this->_stats.collided;
+    } else if (node->airReceive(packet.address, packet.payload, packet.length)) {
+      ++this->_stats.delivered;
+      ++receivers;
+    } else {
+      ++this->_stats.missed;
+    }
+  }
+
+  ESP_LOGVV(TAG, "Packet to 0x%08X %s, %u receivers", packet.address, collided ? "collided" : "clean", receivers);
+
+  packet.from->airTransmitted(receivers);
+}
+
+void AirMedium::dumpStats(void) {
+  const uint32_t elapsed = hal::micros() - this->_startTime;
+  const uint32_t ratio =
+      (this->_stats.receptions > 0) ? (uint32_t) (((uint64_t) this->_stats.delivered * 10000) / this->_stats.receptions)
+                                    : 0;
+  const uint32_t load = (elapsed > 0) ? (uint32_t) ((this->_stats.airtime * 10000) / elapsed) : 0;
+
+  ESP_LOGI(TAG, "Air medium: %u nodes (%u virtual) on channel %u", (unsigned) this->_nodes.size(),
+           (unsigned) this->_virtualNodes.size(), this->_channel);
+  ESP_LOGI(TAG, "  Packets: %u, receptions: %u, delivered: %u, collided: %u, missed: %u", this->_stats.transmissions,
+           this->_stats.receptions, this->_stats.delivered, this->_stats.collided, this->_stats.missed);
+  ESP_LOGI(TAG, "  Delivery ratio: %u.%02u%%, offered load: %u.%02u%%, deferrals: %u", ratio / 100, ratio % 100,
+           load / 100, load % 100, this->_stats.deferrals);
+}
+
+void AirMedium::resetStats(void) {
+  (void) memset(&this->_stats, 0, sizeof(this->_stats));
+  this->_startTime = hal::micros();
+}
+
+uint32_t AirMedium::nextInterval(void) {
+  // Exponentially distributed, i.e. the virtual nodes together form a Poisson process
+  const float uniform = ((this->random() & 0xFFFFFF) + 1) / (float) 0x1000001;
+
+  return (uint32_t) (-logf(uniform) * this->_trafficInterval * 1000.0f);
+}
+
+uint32_t AirMedium::random(void) {
+  this->_random ^= this->_random << 13;
+  this->_random ^= this->_random >> 17;
+  this->_random ^= this->_random << 5;
+  return this->_random;
+}
+
+}  // namespace nrf905
+}  // namespace esphome
+
+#endif /* USE_HOST */
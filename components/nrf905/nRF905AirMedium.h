@@ -0,0 +1,138 @@
+#ifndef __COMPONENT_nRF905_AIR_MEDIUM_H__
+#define __COMPONENT_nRF905_AIR_MEDIUM_H__
+
+#include "esphome/core/defines.h"
+
+#ifdef USE_HOST
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace esphome {
+namespace nrf905 {
+
+#define NRF905_AIR_BIT_TIME 20       // us per bit: 100 kbps Manchester coded, 50 kbps effective
+#define NRF905_AIR_PREAMBLE_BITS 10
+#define NRF905_AIR_MAX_FRAMESIZE 32
+#define NRF905_AIR_BACKOFF_MAX 10000  // us, upper bound of a virtual node's random backoff from a busy channel
+#define NRF905_AIR_CD_DELAY 200       // us, a receiver needs the preamble before carrier detect goes up
+
+/* Anything with an antenna on the simulated air */
+class AirNode {
+ public:
+  virtual uint16_t airChannel(void) = 0;
+  // Would the node's address filter pass a packet for address
+  virtual bool airAddressMatch(const uint32_t address) = 0;
+  // A clean packet arrives. Returns true when the node took it.
+  virtual bool airReceive(const uint32_t address, const uint8_t *const pPayload, const uint8_t length) = 0;
+  // Another node's carrier on our channel came up or went down
+  virtual void airCarrier(const bool carrier) {}
+  // Our packet left the air and receivers nodes took it
+  virtual void airTransmitted(const uint8_t receivers) {}
+};
+
+typedef struct {
+  uint32_t transmissions;
+  uint32_t receptions;  // Packets passing a receiver's address filter
+  uint32_t delivered;
+  uint32_t collided;
+  uint32_t missed;     // Receiver was not listening or still held the previous packet
+  uint32_t deferrals;  // Virtual nodes backing off from a busy channel
+  uint64_t airtime;    // us, summed over all packets
+} AirStats;
+
+/* Discrete-event model of the 868 MHz channel shared by all simulated nodes.
+ *
+ * Nodes announce each packet with its start and end time. When a packet ends it goes to every other node on the
+ * channel whose address filter matches, unless another packet overlapped it on that channel: then nobody gets it.
+ * Carrier state follows every packet from start to end, which is what drives the CD line of emulated radios.
+ *
+ * Besides the attached nodes the medium can run a number of virtual nodes, standing in for the neighbours' remotes
+ * and sensors: they send 16-byte frames to each other at exponentially distributed intervals, optionally listening
+ * before they talk. A persistent node that finds the channel busy sends the moment it clears, the way the old bridge
+ * firmware did. Time is hal::micros(); update() catches up on all events up to now. */
+class AirMedium {
+ public:
+  void attach(AirNode *const node);
+  void transmit(AirNode *const from, const uint32_t start, const uint32_t end, const uint32_t address,
+                const uint8_t *const pPayload, const uint8_t length);
+  // Is any node other than this one detectably on air on its channel at time
+  bool carrier(AirNode *const node, const uint32_t time);
+  void update(void);
+
+  void set_channel(const uint16_t channel) { this->_channel = channel; }
+  void set_virtual_nodes(const uint8_t count) { this->_virtualNodeCount = count; }
+  void set_traffic_interval(const uint32_t interval) { this->_trafficInterval = interval; }
+  void set_listen_before_talk(const bool listen) { this->_listenBeforeTalk = listen; }
+  void set_persistent(const bool persistent) { this->_persistent = persistent; }
+  void set_seed(const uint32_t seed) { this->_random = (seed != 0) ? seed : 1; }
+
+  const AirStats &getStats(void) { return this->_stats; }
+  void dumpStats(void);
+  void resetStats(void);
+
+  // On-air time of one packet
+  static uint32_t packetTime(const uint8_t addressWidth, const uint8_t payloadWidth, const uint8_t crcBytes);
+
+ protected:
+  typedef struct {
+    AirNode *from;
+    uint16_t channel;
+    uint32_t start;  // us
+    uint32_t end;    // us
+    uint32_t address;
+    uint8_t length;
+    uint8_t payload[NRF905_AIR_MAX_FRAMESIZE];
+    bool done;
+  } Packet;
+
+  class VirtualNode : public AirNode {
+   public:
+    VirtualNode(AirMedium *const pMedium, const uint32_t address) : medium_(pMedium), address_(address) {}
+
+    uint16_t airChannel(void) override { return this->medium_->_channel; }
+    bool airAddressMatch(const uint32_t address) override { return address == this->address_; }
+    bool airReceive(const uint32_t address, const uint8_t *const pPayload, const uint8_t length) override;
+
+    AirMedium *medium_;
+    uint32_t address_;
+    uint32_t nextTx_{0};
+    uint32_t busyUntil_{0};
+    uint32_t sent_{0};
+    uint32_t received_{0};
+  };
+
+  void startVirtualNodes(const uint32_t now);
+  void virtualTransmit(VirtualNode *const node, const uint32_t time);
+  void deliver(const size_t index);
+  uint32_t busyUntil(AirNode *const node, const uint32_t time);
+  uint32_t nextInterval(void);
+  uint32_t random(void);
+
+  std::vector<AirNode *> _nodes;
+  std::vector<bool> _carriers;  // Last carrier state reported to each node
+  std::vector<Packet> _packets;
+  std::vector<VirtualNode *> _virtualNodes;
+  bool _updating{false};
+  bool _started{false};
+  uint32_t _startTime{0};
+
+  uint16_t _channel{118};
+  uint8_t _virtualNodeCount{0};
+  uint32_t _trafficInterval{10000};  // ms, mean time between frames of one virtual node
+  bool _listenBeforeTalk{true};
+  bool _persistent{false};
+  uint32_t _random{1};
+
+  AirStats _stats{};
+};
+
+extern AirMedium global_air_medium;
+
+}  // namespace nrf905
+}  // namespace esphome
+
+#endif /* USE_HOST */
+
+#endif /* __COMPONENT_nRF905_AIR_MEDIUM_H__ */
@@ -0,0 +1,231 @@
+#include "nRF905Emulator.h"
+
+#ifdef USE_HOST
+
+#include "esphome/core/log.h"
+
+#include <algorithm>
+#include <string.h>
+
+namespace esphome {
+namespace nrf905 {
+
+static const char *TAG = "nRF905.emulator";
+
+// Power-on reset values of the config register
+static const uint8_t configDefaults[NRF905_REGISTER_COUNT] = {0x6C, 0x00, 0x44, 0x20, 0x20,
+                                                              0xE7, 0xE7, 0xE7, 0xE7, 0xE7};
+
+bool EmulatedPin::digital_read() {
+  this->_chip->update();
+  return this->_level;
+}
+
+void EmulatedPin::digital_write(bool value) {
+  this->_level = value;
+  this->_chip->pinsChanged();
+}
+
+nRF905Emulator::nRF905Emulator() {
+  (void) memcpy(this->_config, configDefaults, NRF905_REGISTER_COUNT);
+  (void) memset(this->_txAddress, 0xE7, sizeof(this->_txAddress));
+  (void) memset(this->_txPayload, 0, NRF905_MAX_FRAMESIZE);
+  (void) memset(this->_rxPayload, 0, NRF905_MAX_FRAMESIZE);
+
+  global_air_medium.attach(this);
+}
+
+uint8_t nRF905Emulator::transfer(const uint8_t command, uint8_t *const pData, const size_t dataLength) {
+  const uint8_t status = this->getStatus();
+  size_t i;
+
+  if ((command & 0xF0) == NRF905_COMMAND_W_CONFIG) {
+    for (i = 0; (i < dataLength) && ((command & 0x0F) + i < NRF905_REGISTER_COUNT); ++i) {
+      this->_config[(command & 0x0F) + i] = pData[i];
+    }
+  } else if ((command & 0xF0) == NRF905_COMMAND_R_CONFIG) {
+    for (i = 0; (i < dataLength) && ((command & 0x0F) + i < NRF905_REGISTER_COUNT); ++i) {
+      pData[i] = this->_config[(command & 0x0F) + i];
+    }
+  } else if ((command & 0xF0) == NRF905_COMMAND_CHANNEL_CONFIG) {
+    // 1000 pphc cccccccc: PA_PWR, HFREQ_PLL and CH[8] share their layout with config byte 1
+    this->_config[1] = (this->_config[1] & 0xF0) | (command & 0x0F);
+    if (dataLength > 0) {
+      this->_config[0] = pData[0];
+    }
+  } else {
+    switch (command) {
+      case NRF905_COMMAND_W_TX_PAYLOAD:
+        (void) memcpy(this->_txPayload, pData, std::min(dataLength, (size_t) NRF905_MAX_FRAMESIZE));
+        break;
+
+      case NRF905_COMMAND_R_TX_PAYLOAD:
+        (void) memcpy(pData, this->_txPayload, std::min(dataLength, (size_t) NRF905_MAX_FRAMESIZE));
+        break;
+
+      case NRF905_COMMAND_W_TX_ADDRESS:
+        (void) memcpy(this->_txAddress, pData, std::min(dataLength, sizeof(this->_txAddress)));
+        break;
+
+      case NRF905_COMMAND_R_TX_ADDRESS:
+        (void) memcpy(pData, this->_txAddress, std::min(dataLength, sizeof(this->_txAddress)));
+        break;
+
+      case NRF905_COMMAND_R_RX_PAYLOAD:
+        (void) memcpy(pData, this->_rxPayload, std::min(dataLength, (size_t) NRF905_MAX_FRAMESIZE));
+        this->_dataReady = false;
+        this->_addressMatch = false;
+        break;
+
+      case NRF905_COMMAND_NOP:
+        break;
+
+      default:
+        ESP_LOGW(TAG, "Unknown command 0x%02X", command);
+        break;
+    }
+  }
+
+  return status;
+}
+
+bool nRF905Emulator::airAddressMatch(const uint32_t address) {
+  const uint8_t addressWidth = this->_config[2] & 0x07;
+  const uint32_t mask = (addressWidth >= 4) ? 0xFFFFFFFF : ((1UL << (addressWidth * 8)) - 1);
+
+  return (address & mask) == (this->getRxAddress() & mask);
+}
+
+bool nRF905Emulator::airReceive(const uint32_t address, const uint8_t *const pPayload, const uint8_t length) {
+  const uint8_t payloadWidth = this->_config[3] & 0x3F;
+
+  this->update();
+
+  // Half duplex: a packet still going out after leaving TX mode keeps the receiver deaf
+  if ((this->_mode != Receive) || this->_transmitting || this->_dataReady) {
+    return false;
+  }
+  if (!this->airAddressMatch(address)) {
+    return false;
+  }
+
+  (void) memset(this->_rxPayload, 0, NRF905_MAX_FRAMESIZE);
+  (void) memcpy(this->_rxPayload, pPayload,
+                std::min(length, std::min(payloadWidth, (uint8_t) NRF905_MAX_FRAMESIZE)));
+  this->_addressMatch = true;
+  this->_dataReady = true;
+
+  return true;
+}
+
+void nRF905Emulator::airCarrier(const bool carrier) {
+  this->update();
+  this->_carrier = carrier;
+  this->_cd.setLevel(this->_carrier && (this->_mode == Receive));
+}
+
+void nRF905Emulator::update(void) {
+  const uint32_t now = hal::micros();
+
+  global_air_medium.update();
+
+  while (this->_transmitting && ((int32_t) (now - this->_packetEnd) >= 0)) {
+    this->finishPacket();
+  }
+}
+
+Mode nRF905Emulator::getMode(void) {
+  this->update();
+  return this->_mode;
+}
+
+uint32_t nRF905Emulator::getRxAddress(void) {
+  return ((uint32_t) this->_config[8] << 24) | (this->_config[7] << 16) | (this->_config[6] << 8) | this->_config[5];
+}
+
+uint32_t nRF905Emulator::getTxAddress(void) {
+  return ((uint32_t) this->_txAddress[3] << 24) | (this->_txAddress[2] << 16) | (this->_txAddress[1] << 8) |
+         this->_txAddress[0];
+}
+
+uint16_t nRF905Emulator::getChannel(void) { return ((this->_config[1] & 0x01) << 8) | this->_config[0]; }
+
+uint32_t nRF905Emulator::getPacketTime(void) {
+  const uint8_t addressWidth = (this->_config[2] >> 4) & 0x07;
+  const uint8_t payloadWidth = this->_config[4] & 0x3F;
+  const uint8_t crcBytes = (this->_config[9] & 0x40) ? ((this->_config[9] & 0x80) ? 2 : 1) : 0;
+
+  return AirMedium::packetTime(addressWidth, payloadWidth, crcBytes);
+}
+
+void nRF905Emulator::pinsChanged(void) {
+  const uint32_t now = hal::micros();
+  Mode mode;
+
+  this->update();
+
+  if (!this->_pwr.getLevel()) {
+    mode = PowerDown;
+  } else if (!this->_ce.getLevel()) {
+    mode = Idle;
+  } else if (this->_txen.getLevel()) {
+    mode = Transmit;
+  } else {
+    mode = Receive;
+  }
+
+  if (mode == this->_mode) {
+    return;
+  }
+
+  if (this->_mode == PowerDown) {
+    this->_readyTime = now + NRF905_EMULATOR_POWERUP_TIME;
+  }
+  if (this->_mode == Transmit) {
+    // DR reported the end of our own packet, it has no meaning in other modes
+    this->_dataReady = false;
+  }
+  if ((mode == Transmit) && !this->_transmitting) {
+    const uint32_t start = ((int32_t) (this->_readyTime - now) > 0) ? this->_readyTime : now;
+
+    this->_transmitting = true;
+    this->_dataReady = false;
+    this->_addressMatch = false;
+    this->startPacket(start + NRF905_EMULATOR_TX_SETTLE_TIME);
+  }
+
+  this->_mode = mode;
+  this->_cd.setLevel(this->_carrier && (this->_mode == Receive));
+}
+
+void nRF905Emulator::startPacket(const uint32_t start) {
+  const uint8_t payloadWidth = this->_config[4] & 0x3F;
+
+  this->_packetEnd = start + this->getPacketTime();
+  global_air_medium.transmit(this, start, this->_packetEnd, this->getTxAddress(), this->_txPayload,
+                             std::min(payloadWidth, (uint8_t) NRF905_MAX_FRAMESIZE));
+}
+
+void nRF905Emulator::finishPacket(void) {
+  ESP_LOGVV(TAG, "Packet sent to 0x%08X", this->getTxAddress());
+
+  // Auto retransmit keeps sending the payload for as long as TX stays enabled
+  if ((this->_mode == Transmit) && (this->_config[1] & 0x20)) {
+    this->startPacket(this->_packetEnd);
+  } else {
+    this->_transmitting = false;
+  }
+  if (this->_mode == Transmit) {
+    this->_dataReady = true;
+  }
+}
+
+uint8_t nRF905Emulator::getStatus(void) {
+  this->update();
+  return (this->_addressMatch ? (1 << NRF905_STATUS_AM) : 0) | (this->_dataReady ? (1 << NRF905_STATUS_DR) : 0);
+}
+
+}  // namespace nrf905
+}  // namespace esphome
+
+#endif /* USE_HOST */
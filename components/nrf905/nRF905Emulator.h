@@ -0,0 +1,112 @@
+#ifndef __COMPONENT_nRF905_EMULATOR_H__
+#define __COMPONENT_nRF905_EMULATOR_H__
+
+#include "esphome/core/defines.h"
+
+#ifdef USE_HOST
+
+#include "esphome/core/gpio.h"
+#include "nRF905.h"
+#include "nRF905AirMedium.h"
+#include "nRF905Hal.h"
+
+#include <string>
+
+namespace esphome {
+namespace nrf905 {
+
+#define NRF905_EMULATOR_POWERUP_TIME 3000  // us from power down to standby
+#define NRF905_EMULATOR_TX_SETTLE_TIME 650  // us from standby to the start of a packet
+
+class nRF905Emulator;
+
+/* GPIO line between the driver and the emulated chip */
+class EmulatedPin : public GPIOPin {
+ public:
+  EmulatedPin(nRF905Emulator *const pChip, const char *const name) : _chip(pChip), _name(name) {}
+
+  void setup() override {}
+  void pin_mode(gpio::Flags flags) override { this->_flags = flags; }
+  gpio::Flags get_flags() const { return this->_flags; }
+  bool digital_read() override;
+  void digital_write(bool value) override;
+  std::string dump_summary() const override { return this->_name; }
+
+  // Chip side, does not notify the chip
+  void setLevel(const bool level) { this->_level = level; }
+  bool getLevel(void) const { return this->_level; }
+
+ protected:
+  nRF905Emulator *_chip;
+  const char *_name;
+  gpio::Flags _flags{gpio::FLAG_NONE};
+  bool _level{false};
+};
+
+/* Register file and radio state machine of an nRF905 behind the SPI bus interface.
+ *
+ * The chip is simulated lazily: every SPI transaction and pin access first advances it to hal::micros(), so it
+ * follows whatever clock is installed. It is a node on global_air_medium: packets are announced there as soon as
+ * their start is known and arrive through airReceive(). DR and AM are reported in the status register only; the
+ * driver runs in status polling mode on the emulator. */
+class nRF905Emulator : public nRF905Bus, public AirNode {
+ public:
+  nRF905Emulator();
+
+  uint8_t transfer(const uint8_t command, uint8_t *const pData, const size_t dataLength) override;
+
+  GPIOPin *getPwrPin(void) { return &this->_pwr; }
+  GPIOPin *getCePin(void) { return &this->_ce; }
+  GPIOPin *getTxenPin(void) { return &this->_txen; }
+  GPIOPin *getCdPin(void) { return &this->_cd; }
+
+  uint16_t airChannel(void) override { return this->getChannel(); }
+  bool airAddressMatch(const uint32_t address) override;
+  // A packet arrives over the air. Returns true when the chip took it: receiving, not sending, FIFO free.
+  bool airReceive(const uint32_t address, const uint8_t *const pPayload, const uint8_t length) override;
+  // Another transmitter is (not) active on our channel
+  void airCarrier(const bool carrier) override;
+
+  // Advance the chip to the current time
+  void update(void);
+
+  Mode getMode(void);
+  uint32_t getRxAddress(void);
+  uint32_t getTxAddress(void);
+  uint16_t getChannel(void);
+  // On-air time of one packet with the current configuration
+  uint32_t getPacketTime(void);
+
+ protected:
+  void pinsChanged(void);
+  void startPacket(const uint32_t start);
+  void finishPacket(void);
+  uint8_t getStatus(void);
+
+  friend class EmulatedPin;
+
+  EmulatedPin _pwr{this, "emulated PWR"};
+  EmulatedPin _ce{this, "emulated CE"};
+  EmulatedPin _txen{this, "emulated TXEN"};
+  EmulatedPin _cd{this, "emulated CD"};
+
+  uint8_t _config[NRF905_REGISTER_COUNT];
+  uint8_t _txAddress[4];
+  uint8_t _txPayload[NRF905_MAX_FRAMESIZE];
+  uint8_t _rxPayload[NRF905_MAX_FRAMESIZE];
+
+  Mode _mode{PowerDown};
+  uint32_t _readyTime{0};  // Earliest start of a packet after power up
+  bool _transmitting{false};
+  uint32_t _packetEnd{0};  // End of the packet on air, the next one starts right after it
+  bool _dataReady{false};
+  bool _addressMatch{false};
+  bool _carrier{false};
+};
+
+}  // namespace nrf905
+}  // namespace esphome
+
+#endif /* USE_HOST */
+
+#endif /* __COMPONENT_nRF905_EMULATOR_H__ */
@@ -0,0 +1,51 @@
+#include "nRF905Hal.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace nrf905 {
+
+static Clock *activeClock = nullptr;
+
+namespace hal {
+
+void setClock(Clock *const pClock) { activeClock = pClock; }
+
+uint32_t millis(void) { return (activeClock != nullptr) ? activeClock->millis() : esphome::millis(); }
+
+uint32_t micros(void) { return (activeClock != nullptr) ? activeClock->micros() : esphome::micros(); }
+
+void delay(const uint32_t ms) {
+  if (activeClock != nullptr) {
+    activeClock->delay(ms);
+  } else {
+    esphome::delay(ms);
+  }
+}
+
+}  // namespace hal
+
+#ifndef USE_HOST
+static const char *TAG = "nRF905";
+
+void nRF905SpiBus::setup(void) { this->spi_setup(); }
+
+void nRF905SpiBus::dumpConfig(void) { LOG_PIN("  CS Pin:", this->cs_); }
+
+uint8_t nRF905SpiBus::transfer(const uint8_t command, uint8_t *const pData, const size_t dataLength) {
+  uint8_t status;
+
+  this->enable();
+
+  status = this->transfer_byte(command);
+  if (dataLength > 0) {
+    this->transfer_array(pData, dataLength);
+  }
+
+  this->disable();
+
+  return status;
+}
+#endif
+
+}  // namespace nrf905
+}  // namespace esphome
@@ -0,0 +1,71 @@
+#ifndef __COMPONENT_nRF905_HAL_H__
+#define __COMPONENT_nRF905_HAL_H__
+
+#include "esphome/core/defines.h"
+#include "esphome/core/hal.h"
+#ifndef USE_HOST
+#include "esphome/components/spi/spi.h"
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace esphome {
+namespace nrf905 {
+
+/* SPI side of the radio. GPIO lines are plain GPIOPins, which are already an abstraction in ESPHome. */
+class nRF905Bus {
+ public:
+  virtual void setup(void) {}
+  virtual void dumpConfig(void) {}
+
+  // One chip-select framed transaction: clocks out command and returns the status byte the chip sends back
+  // meanwhile, then exchanges dataLength bytes of pData in place.
+  virtual uint8_t transfer(const uint8_t command, uint8_t *const pData, const size_t dataLength) = 0;
+};
+
+/* Time source for the driver and protocol. Defaults to the ESPHome clock; host builds can install a virtual one. */
+class Clock {
+ public:
+  virtual uint32_t millis(void) = 0;
+  virtual uint32_t micros(void) = 0;
+  virtual void delay(const uint32_t ms) = 0;
+};
+
+namespace hal {
+
+void setClock(Clock *const pClock);
+uint32_t millis(void);
+uint32_t micros(void);
+void delay(const uint32_t ms);
+
+}  // namespace hal
+
+/* Manually advanced clock, for deterministic runs on a host */
+class VirtualClock : public Clock {
+ public:
+  uint32_t millis(void) override { return (uint32_t) (this->_now / 1000); }
+  uint32_t micros(void) override { return (uint32_t) this->_now; }
+  void delay(const uint32_t ms) override { this->advance(ms * 1000); }
+
+  void advance(const uint64_t us) { this->_now += us; }
+
+ protected:
+  uint64_t _now{0};
+};
+
+#ifndef USE_HOST
+class nRF905SpiBus : public nRF905Bus,
+                     public spi::SPIDevice<spi::BIT_ORDER_MSB_FIRST, spi::CLOCK_POLARITY_LOW,
+                                           spi::CLOCK_PHASE_LEADING, spi::DATA_RATE_1MHZ> {
+ public:
+  void setup(void) override;
+  void dumpConfig(void) override;
+  uint8_t transfer(const uint8_t command, uint8_t *const pData, const size_t dataLength) override;
+};
+#endif
+
+}  // namespace nrf905
+}  // namespace esphome
+
+#endif /* __COMPONENT_nRF905_HAL_H__ */
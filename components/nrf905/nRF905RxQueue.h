@@ -0,0 +1,104 @@
+#ifndef __COMPONENT_nRF905_RX_QUEUE_H__
+#define __COMPONENT_nRF905_RX_QUEUE_H__
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace esphome {
+namespace nrf905 {
+
+#define NRF905_RX_QUEUE_FRAMESIZE 32  // Same as NRF905_MAX_FRAMESIZE, kept separate so this header stands alone
+
+typedef struct {
+  uint32_t time;    // Arrival time (millis)
+  uint8_t length;   // Valid bytes in data
+  uint8_t data[NRF905_RX_QUEUE_FRAMESIZE];
+} RxFrame;
+
+/* Fixed-capacity single-producer/single-consumer ring of received frames.
+ *
+ * The producer (driver loop or ISR) only writes _head, the consumer only writes _tail, so no locking is needed.
+ * Indices run freely and are masked on access, which requires a power-of-two capacity. When the ring is full the
+ * new frame is dropped and counted as an overflow. Has no ESPHome dependencies so it can be built on a host. */
+template<size_t N> class RxQueue {
+  static_assert((N > 0) && ((N & (N - 1)) == 0), "RxQueue capacity must be a power of two");
+
+ public:
+  // Free slot for the next frame, or NULL (and an overflow counted) when full. Fill it, then commit().
+  RxFrame *acquire(void) {
+    const uint32_t head = this->_head.load(std::memory_order_relaxed);
+
+    if ((head - this->_tail.load(std::memory_order_acquire)) >= N) {
+      this->_overflows.fetch_add(1, std::memory_order_relaxed);
+      return NULL;
+    }
+
+    return &this->_frames[head & (N - 1)];
+  }
+
+  // Publish the slot returned by acquire()
+  void commit(void) {
+    const uint32_t head = this->_head.load(std::memory_order_relaxed) + 1;
+    const uint32_t size = head - this->_tail.load(std::memory_order_acquire);
+
+    this->_head.store(head, std::memory_order_release);
+    if (size > this->_highWaterMark.load(std::memory_order_relaxed)) {
+      this->_highWaterMark.store(size, std::memory_order_relaxed);
+    }
+  }
+
+  bool push(const uint8_t *const pData, const uint8_t dataLength, const uint32_t time) {
+    RxFrame *frame = this->acquire();
+
+    if (frame == NULL) {
+      return false;
+    }
+
+    frame->time = time;
+    frame->length = (dataLength > NRF905_RX_QUEUE_FRAMESIZE) ? NRF905_RX_QUEUE_FRAMESIZE : dataLength;
+    (void) memcpy(frame->data, pData, frame->length);
+    this->commit();
+
+    return true;
+  }
+
+  // Oldest frame, or NULL when empty. Stays valid until pop().
+  const RxFrame *front(void) const {
+    const uint32_t tail = this->_tail.load(std::memory_order_relaxed);
+
+    if (tail == this->_head.load(std::memory_order_acquire)) {
+      return NULL;
+    }
+
+    return &this->_frames[tail & (N - 1)];
+  }
+
+  void pop(void) {
+    const uint32_t tail = this->_tail.load(std::memory_order_relaxed);
+
+    if (tail != this->_head.load(std::memory_order_acquire)) {
+      this->_tail.store(tail + 1, std::memory_order_release);
+    }
+  }
+
+  size_t size(void) const {
+    return this->_head.load(std::memory_order_acquire) - this->_tail.load(std::memory_order_acquire);
+  }
+  size_t capacity(void) const { return N; }
+  uint32_t overflows(void) const { return this->_overflows.load(std::memory_order_relaxed); }
+  uint32_t highWaterMark(void) const { return this->_highWaterMark.load(std::memory_order_relaxed); }
+
+ protected:
+  RxFrame _frames[N];
+  std::atomic<uint32_t> _head{0};
+  std::atomic<uint32_t> _tail{0};
+  std::atomic<uint32_t> _overflows{0};
+  std::atomic<uint32_t> _highWaterMark{0};
+};
+
+}  // namespace nrf905
+}  // namespace esphome
+
+#endif /* __COMPONENT_nRF905_RX_QUEUE_H__ */
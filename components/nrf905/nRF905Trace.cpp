@@ -0,0 +1,53 @@
+#include "nRF905Trace.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+#include <string.h>
+
+namespace esphome {
+namespace nrf905 {
+
+#ifdef NRF905_TRACE_BUFFER
+
+static const char *TAG = "trace";
+
+static const char *const traceEventNames[TraceEventCount] = {
+    "ModeChange", "TxPayload",     "TxStart",       "TxReady",    "AddrMatch",     "RxFrame",
+    "RxInvalid",  "RxDropped",     "FrameDispatch", "FrameTx",    "StateChange",   "ReplyTimeout",
+};
+
+Trace global_trace;
+
+void Trace::record(const TraceEvent event, const uint8_t arg, const uint8_t *const pData, const uint8_t dataLength) {
+  TraceRecord *record = &this->_records[this->_count % NRF905_TRACE_SIZE];
+
+  record->time = micros();
+  record->event = event;
+  record->arg = arg;
+  record->length = (dataLength > NRF905_TRACE_DATASIZE) ? NRF905_TRACE_DATASIZE : dataLength;
+  if (record->length > 0) {
+    (void) memcpy(record->data, pData, record->length);
+  }
+
+  ++this->_count;
+}
+
+void Trace::dump(void) {
+  const uint32_t kept = (this->_count > NRF905_TRACE_SIZE) ? NRF905_TRACE_SIZE : this->_count;
+
+  ESP_LOGI(TAG, "Trace: %u records, showing last %u", this->_count, kept);
+
+  for (uint32_t i = this->_count - kept; i < this->_count; ++i) {
+    const TraceRecord *record = &this->_records[i % NRF905_TRACE_SIZE];
+    const char *name = (record->event < TraceEventCount) ? traceEventNames[record->event] : "?";
+
+    ESP_LOGI(TAG, "%10u %-13s %3u %s", record->time, name, record->arg,
+             format_hex_pretty(record->data, record->length).c_str());
+  }
+}
+
+#endif
+
+}  // namespace nrf905
+}  // namespace esphome
@@ -0,0 +1,72 @@
+#ifndef __COMPONENT_nRF905_TRACE_H__
+#define __COMPONENT_nRF905_TRACE_H__
+
+#include "esphome/core/defines.h"
+
+#include <stdint.h>
+
+namespace esphome {
+namespace nrf905 {
+
+#define NRF905_TRACE_SIZE 64      // Records kept, oldest are overwritten
+#define NRF905_TRACE_DATASIZE 16  // Frame bytes kept per record (one Zehnder frame)
+
+typedef enum : uint8_t {
+  // nRF905 driver
+  TraceModeChange,  // arg: new Mode
+  TraceTxPayload,   // data: payload written to the chip
+  TraceTxStart,     // arg: next Mode
+  TraceTxReady,
+  TraceAddrMatch,
+  TraceRxFrame,  // data: payload read from the chip
+  TraceRxInvalid,
+  TraceRxDropped,
+
+  // Zehnder protocol
+  TraceFrameDispatch,  // arg: protocol state, data: frame
+  TraceFrameTransmit,  // arg: reply retries, data: frame
+  TraceStateChange,    // arg: new protocol state
+  TraceReplyTimeout,   // arg: retries left
+
+  TraceEventCount
+} TraceEvent;
+
+typedef struct {
+  uint32_t time;  // micros()
+  uint8_t event;  // TraceEvent
+  uint8_t arg;
+  uint8_t length;  // Valid bytes in data
+  uint8_t data[NRF905_TRACE_DATASIZE];
+} TraceRecord;
+
+/* Binary trace ring. Recording is a bounded memcpy into preallocated RAM; nothing is formatted until dump()
+ * is called, which logs the records oldest-first. */
+class Trace {
+ public:
+  void record(const TraceEvent event, const uint8_t arg, const uint8_t *const pData = nullptr,
+              const uint8_t dataLength = 0);
+  void dump(void);
+  void clear(void) { this->_count = 0; }
+  uint32_t count(void) { return this->_count; }
+
+ protected:
+  TraceRecord _records[NRF905_TRACE_SIZE];
+  uint32_t _count{0};
+};
+
+// Trace points compile out per subsystem, the buffer only exists if at least one of them is enabled
+#if defined(USE_NRF905_TRACE) || defined(USE_ZEHNDER_TRACE)
+#define NRF905_TRACE_BUFFER
+extern Trace global_trace;
+#endif
+
+#ifdef USE_NRF905_TRACE
+#define NRF905_TRACE(...) ::esphome::nrf905::global_trace.record(__VA_ARGS__)
+#else
+#define NRF905_TRACE(...)
+#endif
+
+}  // namespace nrf905
+}  // namespace esphome
+
+#endif /* __COMPONENT_nRF905_TRACE_H__ */
@@ -1,11 +1,17 @@
 import esphome.codegen as cg
 import esphome.config_validation as cv
-from esphome.components import fan, sensor, text_sensor
+import esphome.final_validate as fv
+from esphome.components import binary_sensor, fan, sensor, text_sensor
 from esphome.const import (
     CONF_ID,
+    CONF_TIMEOUT,
     CONF_UPDATE_INTERVAL,
     DEVICE_CLASS_DURATION,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL_INCREASING,
     UNIT_HOUR,
+    UNIT_MILLISECOND,
     UNIT_PERCENT,
     ICON_TIMER,
     ICON_PERCENT,
@@ -14,24 +20,235 @@ from esphome.const import (
     # ICON_ALERT, -> removed
 )
 
-from esphome.components.nrf905 import nRF905Component
+from esphome.components.nrf905 import CONF_POWER_POLICY, nRF905Component
 
 DEPENDENCIES = ["nrf905"]
+AUTO_LOAD = ["binary_sensor", "sensor", "text_sensor"]
 
 zehnder_ns = cg.esphome_ns.namespace("zehnder")
 ZehnderRF = zehnder_ns.class_("ZehnderRF", fan.FanState)
+CsmaAbort = zehnder_ns.enum("CsmaAbort")
+LinkSensor = zehnder_ns.enum("LinkSensor")
+SpeedControl = zehnder_ns.enum("SpeedControl")
+
+SPEED_CONTROL = {
+    "presets": SpeedControl.SpeedControlPresets,
+    "percentage": SpeedControl.SpeedControlPercentage,
+}
+
+CSMA_ABORT = {
+    "drop": CsmaAbort.CsmaAbortDrop,
+    "transmit": CsmaAbort.CsmaAbortTransmit,
+}
 
 CONF_NRF905 = "nrf905"
+CONF_VENTILATION_PERCENTAGE = "ventilation_percentage"
+CONF_VENTILATION_MODE = "ventilation_mode"
+CONF_TIMER = "timer"
+CONF_VOLTAGE_DEADBAND = "voltage_deadband"
+CONF_HEARTBEAT_INTERVAL = "heartbeat_interval"
 CONF_FILTER_REMAINING = "filter_remaining"
 CONF_FILTER_RUNTIME = "filter_runtime"
 CONF_ERROR_COUNT = "error_count"
 CONF_ERROR_CODE = "error_code"
+CONF_TRACE = "trace"
+CONF_CSMA = "csma"
+CONF_SLOT_TIME = "slot_time"
+CONF_MIN_WINDOW = "min_window"
+CONF_MAX_WINDOW = "max_window"
+CONF_ON_TIMEOUT = "on_timeout"
+CONF_MAX_UPDATE_INTERVAL = "max_update_interval"
+CONF_CONFIRM_COMMANDS = "confirm_commands"
+CONF_PASSIVE_TRACKING = "passive_tracking"
+CONF_DEDUP_WINDOW = "dedup_window"
+CONF_SPEED_CONTROL = "speed_control"
+CONF_VOLTAGE_SETTLE = "voltage_settle"
+CONF_CONFIRMATION_LATENCY = "confirmation_latency"
+CONF_STARTUP_TIME = "startup_time"
+CONF_STATE_CONFIRMED = "state_confirmed"
+CONF_DUTY_CYCLE = "duty_cycle"
+CONF_LIMIT = "limit"
+CONF_BURST = "burst"
+CONF_POLL_RESERVE = "poll_reserve"
+CONF_AIRTIME_BUDGET = "airtime_budget"
+CONF_DEFERRED_POLLS = "deferred_polls"
+CONF_DEFERRED_COMMANDS = "deferred_commands"
+CONF_TRANSACTIONS = "transactions"
+CONF_FIRST_TRY_RATE = "first_try_rate"
+CONF_FAILED_TRANSACTIONS = "failed_transactions"
+CONF_REPLY_TIMEOUTS = "reply_timeouts"
+CONF_REPLY_LATENCY = "reply_latency"
+CONF_RETRIES = "retries"
+CONF_AIRWAY_WAIT = "airway_wait"
+CONF_UNEXPECTED_FRAMES = "unexpected_frames"
+CONF_DUPLICATE_FRAMES = "duplicate_frames"
+CONF_UNKNOWN_FRAMES = "unknown_frames"
+CONF_COLLISION_RATE = "collision_rate"
+CONF_CHANNEL_ACCESS_DELAY = "channel_access_delay"
+
+# ETSI EN 300 220 observation period the duty cycle limit applies to
+DUTY_WINDOW_MS = 3600000
+
+
+def validate_csma(config):
+    if config[CONF_MAX_WINDOW] < config[CONF_MIN_WINDOW]:
+        raise cv.Invalid(f"{CONF_MAX_WINDOW} must not be smaller than {CONF_MIN_WINDOW}")
+    return config
+
+
+# Listen before talk: random backoff from a contention window that doubles on every unanswered frame
+CSMA_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.Optional(
+                CONF_SLOT_TIME, default="1ms"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_MIN_WINDOW, default=8): cv.int_range(min=1, max=1024),
+            cv.Optional(CONF_MAX_WINDOW, default=128): cv.int_range(min=1, max=1024),
+            cv.Optional(
+                CONF_TIMEOUT, default="5s"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_ON_TIMEOUT, default="drop"): cv.enum(CSMA_ABORT, lower=True),
+        }
+    ),
+    validate_csma,
+)
+
+def validate_duty_cycle(config):
+    allowance = config[CONF_LIMIT] * DUTY_WINDOW_MS
+    if config[CONF_BURST].total_milliseconds >= allowance:
+        raise cv.Invalid(
+            f"{CONF_BURST} must be shorter than the {allowance / 1000:g}s of airtime {CONF_LIMIT} allows per hour"
+        )
+    return config
 
-CONFIG_SCHEMA = fan.FAN_SCHEMA.extend(
+
+# Token bucket of airtime in front of every transmission; polls stop before commands do
+DUTY_CYCLE_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.Optional(CONF_LIMIT, default="1%"): cv.All(
+                cv.percentage, cv.Range(min=0.0001, max=1.0)
+            ),
+            cv.Optional(
+                CONF_BURST, default="1s"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_POLL_RESERVE, default="50%"): cv.percentage,
+        }
+    ),
+    validate_duty_cycle,
+)
+
+DUTY_COUNT_SCHEMA = sensor.sensor_schema(
+    accuracy_decimals=0,
+    state_class=STATE_CLASS_TOTAL_INCREASING,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    icon="mdi:timer-sand",
+)
+
+LINK_COUNT_SCHEMA = sensor.sensor_schema(
+    accuracy_decimals=0,
+    state_class=STATE_CLASS_TOTAL_INCREASING,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    icon="mdi:counter",
+)
+
+LINK_TIME_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement=UNIT_MILLISECOND,
+    accuracy_decimals=1,
+    device_class=DEVICE_CLASS_DURATION,
+    state_class=STATE_CLASS_MEASUREMENT,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    icon="mdi:timer-outline",
+)
+
+# Link quality sensors since boot or the last resetLinkStats(), by LinkSensor
+LINK_SENSORS = {
+    CONF_TRANSACTIONS: (LinkSensor.LinkSensorTransactions, LINK_COUNT_SCHEMA),
+    CONF_FIRST_TRY_RATE: (
+        LinkSensor.LinkSensorFirstTryRate,
+        sensor.sensor_schema(
+            unit_of_measurement=UNIT_PERCENT,
+            accuracy_decimals=1,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            icon="mdi:signal",
+        ),
+    ),
+    CONF_FAILED_TRANSACTIONS: (LinkSensor.LinkSensorFailed, LINK_COUNT_SCHEMA),
+    CONF_REPLY_TIMEOUTS: (LinkSensor.LinkSensorTimeouts, LINK_COUNT_SCHEMA),
+    CONF_REPLY_LATENCY: (LinkSensor.LinkSensorReplyLatency, LINK_TIME_SCHEMA),
+    CONF_RETRIES: (
+        LinkSensor.LinkSensorRetries,
+        sensor.sensor_schema(
+            accuracy_decimals=2,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            icon="mdi:repeat",
+        ),
+    ),
+    CONF_AIRWAY_WAIT: (LinkSensor.LinkSensorAirwayWait, LINK_TIME_SCHEMA),
+    CONF_UNEXPECTED_FRAMES: (LinkSensor.LinkSensorUnexpected, LINK_COUNT_SCHEMA),
+    CONF_DUPLICATE_FRAMES: (LinkSensor.LinkSensorDuplicates, LINK_COUNT_SCHEMA),
+    CONF_UNKNOWN_FRAMES: (LinkSensor.LinkSensorUnknownSource, LINK_COUNT_SCHEMA),
+}
+
+def validate_update_interval(config):
+    if config[CONF_MAX_UPDATE_INTERVAL] < config[CONF_UPDATE_INTERVAL]:
+        raise cv.Invalid(
+            f"{CONF_MAX_UPDATE_INTERVAL} must not be shorter than {CONF_UPDATE_INTERVAL}"
+        )
+    return config
+
+
+CONFIG_SCHEMA = cv.All(fan.FAN_SCHEMA.extend(
     {
         cv.GenerateID(): cv.declare_id(ZehnderRF),
         cv.Required(CONF_NRF905): cv.use_id(nRF905Component),
+        # Polls start at update_interval and stretch up to max_update_interval while nothing changes
         cv.Optional(CONF_UPDATE_INTERVAL, default="30s"): cv.update_interval,
+        cv.Optional(CONF_MAX_UPDATE_INTERVAL, default="5min"): cv.update_interval,
+        cv.Optional(CONF_TRACE, default=False): cv.boolean,
+        # Wait for the unit to acknowledge speed changes and publish the state only then
+        cv.Optional(CONF_CONFIRM_COMMANDS, default=True): cv.boolean,
+        # Follow other remotes' speed changes and the unit's unsolicited settings between polls. Needs the radio
+        # listening: with passive_tracking off it may power down, and changes made elsewhere show on the next poll,
+        # up to max_update_interval later
+        cv.Optional(CONF_PASSIVE_TRACKING, default=True): cv.boolean,
+        # Fan speed as the four presets, or as the output voltage 1-100%; a percentage is sent once the
+        # slider has rested for voltage_settle
+        cv.Optional(CONF_SPEED_CONTROL, default="presets"): cv.enum(SPEED_CONTROL, lower=True),
+        cv.Optional(
+            CONF_VOLTAGE_SETTLE, default="500ms"
+        ): cv.positive_time_period_milliseconds,
+        # Drop copies of a frame received again within this, 0 to handle every copy. Copies are only looked for
+        # among frames heard since the last request went out, so an answer is never taken for a copy
+        cv.Optional(CONF_DEDUP_WINDOW, default="50ms"): cv.All(
+            cv.positive_time_period_milliseconds,
+            cv.Range(max=cv.TimePeriod(milliseconds=100)),
+        ),
+        cv.Optional(CONF_CSMA, default={}): CSMA_SCHEMA,
+        cv.Optional(CONF_DUTY_CYCLE, default={}): DUTY_CYCLE_SCHEMA,
+        # Fan state is published when it changes; the voltage only once it moved more than the deadband, and with a
+        # heartbeat interval unchanged values are republished that often (on the next poll)
+        cv.Optional(CONF_VOLTAGE_DEADBAND, default=0): cv.int_range(min=0, max=100),
+        cv.Optional(
+            CONF_HEARTBEAT_INTERVAL, default="0s"
+        ): cv.positive_time_period_milliseconds,
+
+        # Fan state sensors
+        cv.Optional(CONF_VENTILATION_PERCENTAGE): sensor.sensor_schema(
+            unit_of_measurement=UNIT_PERCENT,
+            accuracy_decimals=0,
+            state_class=STATE_CLASS_MEASUREMENT,
+            icon=ICON_PERCENT,
+        ),
+        cv.Optional(CONF_TIMER): binary_sensor.binary_sensor_schema(
+            icon="mdi:fan-clock",
+        ),
+        cv.Optional(CONF_VENTILATION_MODE): text_sensor.text_sensor_schema(
+            icon="mdi:information",
+        ),
 
         # Filter status sensors
         cv.Optional(CONF_FILTER_REMAINING): sensor.sensor_schema(
@@ -51,8 +268,79 @@ CONFIG_SCHEMA = fan.FAN_SCHEMA.extend(
         cv.Optional(CONF_ERROR_CODE): text_sensor.text_sensor_schema(
             icon="mdi:alert",  # Using string directly instead of constant
         ),
+
+        # Off while the fan state comes from another remote's command the unit hasn't acknowledged yet
+        cv.Optional(CONF_STATE_CONFIRMED): binary_sensor.binary_sensor_schema(
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            icon="mdi:check-network-outline",
+        ),
+
+        # Time from a speed change being requested until the unit acknowledged it
+        cv.Optional(CONF_CONFIRMATION_LATENCY): sensor.sensor_schema(
+            unit_of_measurement=UNIT_MILLISECOND,
+            accuracy_decimals=0,
+            device_class=DEVICE_CLASS_DURATION,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            icon="mdi:timer-check-outline",
+        ),
+
+        # Time from boot until the first fan status came in
+        cv.Optional(CONF_STARTUP_TIME): sensor.sensor_schema(
+            unit_of_measurement=UNIT_MILLISECOND,
+            accuracy_decimals=0,
+            device_class=DEVICE_CLASS_DURATION,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            icon="mdi:timer-play-outline",
+        ),
+
+        # Duty cycle sensors
+        cv.Optional(CONF_AIRTIME_BUDGET): sensor.sensor_schema(
+            unit_of_measurement=UNIT_MILLISECOND,
+            accuracy_decimals=1,
+            device_class=DEVICE_CLASS_DURATION,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            icon="mdi:radio-tower",
+        ),
+        cv.Optional(CONF_DEFERRED_POLLS): DUTY_COUNT_SCHEMA,
+        cv.Optional(CONF_DEFERRED_COMMANDS): DUTY_COUNT_SCHEMA,
+
+        # Link quality sensors, published every minute
+        **{cv.Optional(key): schema for key, (_, schema) in LINK_SENSORS.items()},
+
+        # Channel access sensors, published every minute: transmissions left unanswered, collided or lost, and the
+        # average time from wanting to send until on air
+        cv.Optional(CONF_COLLISION_RATE): sensor.sensor_schema(
+            unit_of_measurement=UNIT_PERCENT,
+            accuracy_decimals=1,
+            state_class=STATE_CLASS_MEASUREMENT,
+            entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            icon="mdi:call-split",
+        ),
+        cv.Optional(CONF_CHANNEL_ACCESS_DELAY): LINK_TIME_SCHEMA,
     }
-).extend(cv.COMPONENT_SCHEMA)
+).extend(cv.COMPONENT_SCHEMA), validate_update_interval)
+
+
+def final_validate(config):
+    if not config[CONF_PASSIVE_TRACKING]:
+        return config
+    full_config = fv.full_config.get()
+    rf_path = full_config.get_path_for_id(config[CONF_NRF905])[:-1]
+    policy = full_config.get_config_for_path(rf_path)[CONF_POWER_POLICY]
+    if policy != "always_on":
+        raise cv.Invalid(
+            f"nrf905 {CONF_POWER_POLICY} {policy} powers the radio down between polls, so other remotes and the "
+            f"unit's unsolicited updates go unheard. Set {CONF_PASSIVE_TRACKING}: false to accept that, or use "
+            f"{CONF_POWER_POLICY}: always_on",
+            path=[CONF_PASSIVE_TRACKING],
+        )
+    return config
+
+
+FINAL_VALIDATE_SCHEMA = final_validate
 
 
 async def to_code(config):
@@ -64,8 +352,43 @@ async def to_code(config):
     cg.add(var.set_rf(nrf905))
 
     cg.add(var.set_update_interval(config[CONF_UPDATE_INTERVAL]))
+    cg.add(var.set_max_update_interval(config[CONF_MAX_UPDATE_INTERVAL]))
+    cg.add(var.set_confirm_commands(config[CONF_CONFIRM_COMMANDS]))
+    cg.add(var.set_passive_tracking(config[CONF_PASSIVE_TRACKING]))
+    cg.add(var.set_speed_control(config[CONF_SPEED_CONTROL]))
+    cg.add(var.set_voltage_settle(config[CONF_VOLTAGE_SETTLE]))
+    cg.add(var.set_dedup_window(config[CONF_DEDUP_WINDOW]))
+    cg.add(var.set_voltage_deadband(config[CONF_VOLTAGE_DEADBAND]))
+    cg.add(var.set_heartbeat_interval(config[CONF_HEARTBEAT_INTERVAL]))
+
+    csma = config[CONF_CSMA]
+    cg.add(var.set_csma_slot_time(csma[CONF_SLOT_TIME]))
+    cg.add(var.set_csma_min_window(csma[CONF_MIN_WINDOW]))
+    cg.add(var.set_csma_max_window(csma[CONF_MAX_WINDOW]))
+    cg.add(var.set_csma_timeout(csma[CONF_TIMEOUT]))
+    cg.add(var.set_csma_abort(csma[CONF_ON_TIMEOUT]))
+
+    duty = config[CONF_DUTY_CYCLE]
+    cg.add(var.set_duty_cycle_limit(int(round(duty[CONF_LIMIT] * 1000000))))
+    cg.add(var.set_duty_cycle_burst(duty[CONF_BURST]))
+    cg.add(var.set_duty_cycle_poll_reserve(int(round(duty[CONF_POLL_RESERVE] * 100))))
+
+    if config[CONF_TRACE]:
+        cg.add_define("USE_ZEHNDER_TRACE")
 
     # Register sensors if defined
+    if CONF_VENTILATION_PERCENTAGE in config:
+        sens = await sensor.new_sensor(config[CONF_VENTILATION_PERCENTAGE])
+        cg.add(var.set_ventilation_percentage_sensor(sens))
+
+    if CONF_TIMER in config:
+        sens = await binary_sensor.new_binary_sensor(config[CONF_TIMER])
+        cg.add(var.set_timer_binary_sensor(sens))
+
+    if CONF_VENTILATION_MODE in config:
+        sens = await text_sensor.new_text_sensor(config[CONF_VENTILATION_MODE])
+        cg.add(var.set_ventilation_mode_text_sensor(sens))
+
     if CONF_FILTER_REMAINING in config:
         sens = await sensor.new_sensor(config[CONF_FILTER_REMAINING])
         cg.add(var.set_filter_remaining_sensor(sens))
@@ -81,3 +404,40 @@ async def to_code(config):
     if CONF_ERROR_CODE in config:
         sens = await text_sensor.new_text_sensor(config[CONF_ERROR_CODE])
         cg.add(var.set_error_code_sensor(sens))
+
+    if CONF_STATE_CONFIRMED in config:
+        sens = await binary_sensor.new_binary_sensor(config[CONF_STATE_CONFIRMED])
+        cg.add(var.set_state_confirmed_binary_sensor(sens))
+
+    if CONF_CONFIRMATION_LATENCY in config:
+        sens = await sensor.new_sensor(config[CONF_CONFIRMATION_LATENCY])
+        cg.add(var.set_confirmation_latency_sensor(sens))
+
+    if CONF_STARTUP_TIME in config:
+        sens = await sensor.new_sensor(config[CONF_STARTUP_TIME])
+        cg.add(var.set_startup_time_sensor(sens))
+
+    if CONF_AIRTIME_BUDGET in config:
+        sens = await sensor.new_sensor(config[CONF_AIRTIME_BUDGET])
+        cg.add(var.set_airtime_budget_sensor(sens))
+
+    if CONF_DEFERRED_POLLS in config:
+        sens = await sensor.new_sensor(config[CONF_DEFERRED_POLLS])
+        cg.add(var.set_deferred_polls_sensor(sens))
+
+    if CONF_DEFERRED_COMMANDS in config:
+        sens = await sensor.new_sensor(config[CONF_DEFERRED_COMMANDS])
+        cg.add(var.set_deferred_commands_sensor(sens))
+
+    for key, (which, _) in LINK_SENSORS.items():
+        if key in config:
+            sens = await sensor.new_sensor(config[key])
+            cg.add(var.set_link_sensor(which, sens))
+
+    if CONF_COLLISION_RATE in config:
+        sens = await sensor.new_sensor(config[CONF_COLLISION_RATE])
+        cg.add(var.set_collision_rate_sensor(sens))
+
+    if CONF_CHANNEL_ACCESS_DELAY in config:
+        sens = await sensor.new_sensor(config[CONF_CHANNEL_ACCESS_DELAY])
+        cg.add(var.set_access_delay_sensor(sens))
@@ -1,28 +1,29 @@
 #include "zehnder.h"
 #include "esphome/core/log.h"
 #include "esphome/core/application.h"
-#include "esphome/components/wifi/wifi_component.h"
-#include "esphome/components/network/util.h"
+#include "esphome/core/helpers.h"
 #include <string>
 #include <algorithm>
 #include <vector>
+#include <cmath>
 
 namespace esphome {
 namespace zehnder {
 
 static const char *const TAG = "zehnder";
 
-// Helper function: Convert byte array to hex string
-static std::string bytes_to_hex(const uint8_t *data, size_t len) {
-  std::string res = "";
-  const char *hex_chars = "0123456789ABCDEF";
-  for (size_t i = 0; i < len; ++i) {
-    if (i > 0)
-      res += " ";
-    res += hex_chars[data[i] >> 4];
-    res += hex_chars[data[i] & 0x0F];
+// Time comes from the radio HAL so the protocol can run on a virtual clock
+using nrf905::hal::millis;
+
+// Histogram bucket: the first edge, doubling up to the last bucket
+static uint8_t histogramBucket(const uint32_t value, uint32_t edge) {
+  uint8_t bucket = 0;
+
+  while ((bucket < (FAN_HISTOGRAM_BUCKETS - 1)) && (value >= edge)) {
+    ++bucket;
+    edge <<= 1;
   }
-  return res;
+  return bucket;
 }
 
 // Helper function: Clamp value between min and max
@@ -34,25 +35,49 @@ static uint8_t clamp(const uint8_t value, const uint8_t min_val, const uint8_t m
 ZehnderRF::ZehnderRF(void) {}
 
 // Define Fan Traits
-fan::FanTraits ZehnderRF::get_traits() { return fan::FanTraits(false, true, false, this->speed_count_); }
+fan::FanTraits ZehnderRF::get_traits() { return fan::FanTraits(false, true, false, this->get_speed_count()); }
 
 // Handle Fan Control Calls from Home Assistant
 void ZehnderRF::control(const fan::FanCall &call) {
+  bool state = this->state;
+  int speed = this->speed;
+
   if (call.get_state().has_value()) {
-    this->state = *call.get_state(); // Update internal ON/OFF state
-    ESP_LOGD(TAG, "Control call: State=%s", ONOFF(this->state));
+    state = *call.get_state();
+    ESP_LOGD(TAG, "Control call: State=%s", ONOFF(state));
   }
   if (call.get_speed().has_value()) {
-    this->speed = *call.get_speed(); // Update internal speed level
-    ESP_LOGD(TAG, "Control call: Speed=%d", this->speed);
+    speed = *call.get_speed();
+    ESP_LOGD(TAG, "Control call: Speed=%d", speed);
   }
 
-  // Mark that a new setting needs to be sent
-  this->newSetting = true;
-  this->newSpeed = this->state ? this->speed : FAN_SPEED_AUTO; // Map ON/OFF state and speed level
-  this->newTimer = 0; // Timer control not implemented via standard fan call yet
+  if ((this->speedControl_ == SpeedControlPercentage) && state) {
+    // Turning on without a speed, or at 0, resumes the last percentage; the entity shows 1 while off
+    int percentage = call.get_speed().has_value() ? std::min(speed, FAN_PERCENTAGE_STEPS) : 0;
+    if (percentage <= 0) {
+      percentage = this->lastVoltage_;
+    }
+    this->lastVoltage_ = (uint8_t) percentage;
+
+    // A slider sends a call per step: only the value it rests at goes out
+    this->settleVoltage_ = (uint8_t) percentage;
+    this->set_timeout("voltage_settle", this->voltageSettle_, [this]() { this->setVoltage(this->settleVoltage_); });
+    if (!this->confirmCommands_) {
+      this->publishVoltage(this->settleVoltage_);
+      this->setStateConfirmed(false);
+    }
+    return;
+  }
+  this->cancel_timeout("voltage_settle"); // Off wins over a slider still moving
+
+  // Map ON/OFF state and speed level; timer control not implemented via standard fan call yet
+  this->setSpeed(state ? speed : FAN_SPEED_AUTO, 0);
 
-  this->publish_state(); // Optimistically publish the state
+  // Confirmed commands publish once the unit acknowledges; otherwise publish optimistically
+  if (!this->confirmCommands_) {
+    this->publishSpeed(state ? speed : FAN_SPEED_AUTO, 0);
+    this->setStateConfirmed(false);
+  }
 }
 
 // Component Setup
@@ -66,11 +91,32 @@ void ZehnderRF::setup() {
   if (this->pref_.load(&this->config_)) {
     ESP_LOGD(TAG, "Loaded config - NetworkId: 0x%08X, MyDeviceId: 0x%02X, MainUnitId: 0x%02X",
              this->config_.fan_networkId, this->config_.fan_my_device_id, this->config_.fan_main_unit_id);
+    if (!this->pairingValid()) {
+      ESP_LOGW(TAG, "Stored pairing is incomplete or corrupt, pairing again.");
+      memset(&this->config_, 0, sizeof(Config));
+    }
   } else {
     ESP_LOGW(TAG, "Failed to load config. Starting fresh.");
     memset(&this->config_, 0, sizeof(Config));
   }
 
+  // Round trip estimate from the last run, if it is for the same main unit
+  this->linkPref_ = global_preferences->make_preference<LinkEstimate>(fnv1_hash("zehnderrf_link"), true);
+  if (!this->linkPref_.load(&this->link_) || (this->link_.networkId != this->config_.fan_networkId) ||
+      (this->link_.mainUnitId != this->config_.fan_main_unit_id)) {
+    this->linkReset();
+  }
+  this->set_interval("link_save", FAN_LINK_SAVE_INTERVAL, [this]() { this->linkSave(); });
+  for (uint8_t i = 0; i < LinkSensorCount; ++i) {
+    if (this->link_sensors_[i] != nullptr) {
+      this->set_interval("link_stats", FAN_STATS_PUBLISH_INTERVAL, [this]() { this->publishLinkStats(); });
+      break;
+    }
+  }
+  if ((this->collision_rate_sensor_ != nullptr) || (this->access_delay_sensor_ != nullptr)) {
+    this->set_interval("csma_stats", FAN_STATS_PUBLISH_INTERVAL, [this]() { this->publishCsmaStats(); });
+  }
+
   // Configure nRF905 Radio
   nrf905::Config rfConfig = this->rf_->getConfig(); // Get current config (defaults)
   rfConfig.band = true; // 868 MHz band
@@ -86,18 +132,35 @@ void ZehnderRF::setup() {
   rfConfig.xtal_frequency = 16000000;
   rfConfig.clkOutFrequency = nrf905::ClkOut500000;
   rfConfig.clkOutEnable = false;
-  rfConfig.auto_retransmit = false; // Start with retransmit off (used in discovery)
-  rfConfig.rx_address = NETWORK_LINK_ID; // Initial address for discovery
-
-  this->rf_->updateConfig(&rfConfig); // Apply configuration
-  this->rf_->writeTxAddress(NETWORK_LINK_ID); // Set initial TX address
+  // Paired: straight onto the network, otherwise on the link address with retransmit off for discovery. The radio
+  // is still powering up, so this goes out as its one and only register write.
+  const uint32_t address = (this->config_.fan_networkId != 0) ? this->config_.fan_networkId : NETWORK_LINK_ID;
+  rfConfig.auto_retransmit = (this->config_.fan_networkId != 0);
+  rfConfig.rx_address = address;
+
+  {
+    nrf905::nRF905Transaction transaction(this->rf_); // Single standby entry for both writes
+    this->rf_->updateConfig(&rfConfig); // Apply configuration
+    this->rf_->writeTxAddress(address);
+  }
 
   this->speed_count_ = 4; // Number of speed presets (Low, Medium, High, Max)
   this->state_ = StateStartup; // Set initial state machine state
   this->lastFanQuery_ = 0;
-  this->newSetting = false;
   this->rfState_ = RfStateIdle;
 
+  // Airtime budget: whatever the bucket can hold on top of the refill must fit in one observation period
+  const uint64_t allowance = ((uint64_t) FAN_DUTY_WINDOW * this->dutyLimit_) / 1000000; // ms
+  this->dutyRate_ = (allowance > this->dutyBurst_)
+                        ? (uint32_t) (((allowance - this->dutyBurst_) * 1000000) / FAN_DUTY_WINDOW)
+                        : 0;
+  this->dutyTokens_ = (uint64_t) this->dutyBurst_ * 1000000;
+  this->dutyUpdated_ = millis();
+  if ((this->airtime_budget_sensor_ != nullptr) || (this->deferred_polls_sensor_ != nullptr) ||
+      (this->deferred_commands_sensor_ != nullptr)) {
+    this->set_interval("duty_cycle", FAN_DUTY_PUBLISH_INTERVAL, [this]() { this->publishDutyCycle(); });
+  }
+
   // Setup nRF905 callbacks
   this->rf_->setOnTxReady([this](void) {
     ESP_LOGV(TAG, "nRF905: TX Ready");
@@ -107,19 +170,18 @@ void ZehnderRF::setup() {
         this->rfState_ = RfStateRxWait; // Move to wait for reply state
       } else { // If no reply expected
         this->rfState_ = RfStateIdle; // TX done, return to idle
+        this->csmaWindow_ = this->csmaMinWindow_; // Nothing to tell a collision by, count it as a success
         // If we were waiting for TX confirmation, now we can go idle
         if(this->state_ == StateWaitSetSpeedConfirm) {
             ESP_LOGD(TAG, "SetSpeed TX complete, returning to Idle state.");
             this->state_ = StateIdle;
+            this->completeCommand(CommandDone);
         }
       }
     }
   });
 
-  this->rf_->setOnRxComplete([this](const uint8_t *const pData, const uint8_t dataLength) {
-    ESP_LOGV(TAG, "nRF905: RX Complete");
-    this->rfHandleReceived(pData, dataLength);
-  });
+  // Received frames are not delivered by callback; loop() drains the radio's RX queue
 
   ESP_LOGCONFIG(TAG, "ZehnderRF setup complete.");
 }
@@ -127,7 +189,21 @@ void ZehnderRF::setup() {
 // Dump Configuration
 void ZehnderRF::dump_config(void) {
   ESP_LOGCONFIG(TAG, "ZehnderRF Component Configuration:");
-  ESP_LOGCONFIG(TAG, "  Configured Update Interval: %u ms", this->interval_);
+  ESP_LOGCONFIG(TAG, "  Configured Update Interval: %u..%u ms", this->interval_, this->maxInterval_);
+  ESP_LOGCONFIG(TAG, "  Confirm Commands: %s", YESNO(this->confirmCommands_));
+  if (this->speedControl_ == SpeedControlPercentage) {
+    ESP_LOGCONFIG(TAG, "  Speed Control: percentage, settle %u ms", this->voltageSettle_);
+  } else {
+    ESP_LOGCONFIG(TAG, "  Speed Control: presets");
+  }
+  ESP_LOGCONFIG(TAG, "  Duplicate Window: %u ms", this->dedupWindow_);
+  ESP_LOGCONFIG(TAG, "  Publish: voltage deadband %u%%, heartbeat %u ms", this->voltageDeadband_,
+                this->heartbeatInterval_);
+  ESP_LOGCONFIG(TAG, "  CSMA: slot %u ms, window %u..%u slots, timeout %u ms (%s)", this->csmaSlotTime_,
+                this->csmaMinWindow_, this->csmaMaxWindow_, this->csmaTimeout_,
+                (this->csmaAbort_ == CsmaAbortTransmit) ? "transmit" : "drop");
+  ESP_LOGCONFIG(TAG, "  Duty cycle: %u.%04u%%, burst %u ms, refill %u ppm, poll reserve %u%%", this->dutyLimit_ / 10000,
+                this->dutyLimit_ % 10000, this->dutyBurst_, this->dutyRate_, this->dutyPollReserve_);
   ESP_LOGCONFIG(TAG, "  Paired Network ID: 0x%08X", this->config_.fan_networkId);
   ESP_LOGCONFIG(TAG, "  My Device Type: 0x%02X", this->config_.fan_my_device_type);
   ESP_LOGCONFIG(TAG, "  My Device ID: 0x%02X", this->config_.fan_my_device_id);
@@ -135,41 +211,52 @@ void ZehnderRF::dump_config(void) {
   ESP_LOGCONFIG(TAG, "  Main Unit ID: 0x%02X", this->config_.fan_main_unit_id);
   LOG_SENSOR("  ", "Ventilation Percentage Sensor", this->ventilation_percentage_sensor_);
   LOG_BINARY_SENSOR("  ", "Timer Binary Sensor", this->timer_binary_sensor_);
+  LOG_BINARY_SENSOR("  ", "State Confirmed Binary Sensor", this->state_confirmed_binary_sensor_);
   LOG_TEXT_SENSOR("  ", "Ventilation Mode Sensor", this->ventilation_mode_text_sensor_);
   LOG_SENSOR("  ", "Filter Remaining Sensor", this->filter_remaining_sensor_);
   LOG_SENSOR("  ", "Filter Runtime Sensor", this->filter_runtime_sensor_);
   LOG_SENSOR("  ", "Error Count Sensor", this->error_count_sensor_);
   LOG_TEXT_SENSOR("  ", "Error Code Sensor", this->error_code_sensor_);
+  LOG_SENSOR("  ", "Confirmation Latency Sensor", this->confirmation_latency_sensor_);
+  LOG_SENSOR("  ", "Startup Time Sensor", this->startup_time_sensor_);
+  for (uint8_t i = 0; i < LinkSensorCount; ++i) {
+    LOG_SENSOR("  ", "Link Sensor", this->link_sensors_[i]);
+  }
+  LOG_SENSOR("  ", "Collision Rate Sensor", this->collision_rate_sensor_);
+  LOG_SENSOR("  ", "Access Delay Sensor", this->access_delay_sensor_);
+  LOG_SENSOR("  ", "Airtime Budget Sensor", this->airtime_budget_sensor_);
+  LOG_SENSOR("  ", "Deferred Polls Sensor", this->deferred_polls_sensor_);
+  LOG_SENSOR("  ", "Deferred Commands Sensor", this->deferred_commands_sensor_);
 }
 
+void ZehnderRF::on_shutdown() { this->linkSave(); }
+
 // Main Loop Logic
 void ZehnderRF::loop(void) {
+  this->rfDispatchReceived(); // Handle frames queued by the radio, before timeouts are evaluated
   this->rfHandler(); // Process RF state machine (timeouts, etc.)
 
+#ifdef USE_ZEHNDER_TRACE
+  if (this->state_ != this->tracedState_) {
+    ZEHNDER_TRACE(nrf905::TraceStateChange, this->state_);
+    this->tracedState_ = this->state_;
+  }
+#endif
+
   uint8_t deviceId;
-  nrf905::Config rfConfig;
 
   // Main state machine
   switch (this->state_) {
     case StateStartup:
-      // Give some time for system to stabilize after boot
-      if (millis() > 10000) { // Wait 10 seconds
-        // Check if we have valid pairing info
-        if ((this->config_.fan_networkId == 0x00000000) || (this->config_.fan_my_device_type == 0) ||
-            (this->config_.fan_my_device_id == 0) || (this->config_.fan_main_unit_type == 0) ||
-            (this->config_.fan_main_unit_id == 0)) {
+      // setup() already configured the radio for what comes next, it only has to be up
+      if (this->rf_->isReady()) {
+        if (this->config_.fan_networkId == 0) {
           ESP_LOGI(TAG, "No valid pairing config found. Starting discovery...");
           this->state_ = StateStartDiscovery;
         } else {
           ESP_LOGI(TAG, "Valid pairing config found. Starting normal operation.");
-          // Apply paired configuration to radio
-          rfConfig = this->rf_->getConfig();
-          rfConfig.rx_address = this->config_.fan_networkId;
-          rfConfig.auto_retransmit = true; // Enable retransmit for normal operation
-          this->rf_->updateConfig(&rfConfig);
-          this->rf_->writeTxAddress(this->config_.fan_networkId);
           this->state_ = StateIdle;
-          this->lastFanQuery_ = millis() - this->interval_; // Force initial query soon
+          this->lastFanQuery_ = millis() - this->pollInterval_; // First query right away
         }
       }
       break;
@@ -191,23 +278,38 @@ void ZehnderRF::loop(void) {
       // State change happens in the OnTxReady callback.
       break;
 
+    case StateWaitSetSpeedReply:
+      // Waiting for FAN_FRAME_SETSPEED_REPLY or FAN_TYPE_FAN_SETTINGS.
+      // State change happens in rfHandleReceived or timeout via rfHandler.
+      break;
+
     case StateWaitFanSettings:
       // Waiting for FAN_TYPE_FAN_SETTINGS reply.
       // State change happens in rfHandleReceived or timeout via rfHandler.
       break;
 
     case StateIdle:
-      // Check if a command from Home Assistant is pending
-      if (this->newSetting) {
-        ESP_LOGD(TAG, "Idle: New setting pending (Speed: %d), sending command.", this->newSpeed);
-        this->setSpeed(this->newSpeed, this->newTimer);
-        this->newSetting = false; // Clear the flag
-      } 
-      // Otherwise, check if it's time for a periodic status query
-      else if ((millis() - this->lastFanQuery_) >= this->interval_) {
+      // Periodic status query, behind any user command already queued
+      if ((millis() - this->lastFanQuery_) >= this->pollInterval_) {
         ESP_LOGD(TAG, "Idle: Polling interval reached. Querying device status.");
-        this->queryDevice();
-        this->lastFanQuery_ = millis(); // Reset timer *after* initiating query
+        Command poll{};
+        poll.type = CommandQuery;
+        poll.priority = CommandPriorityPoll;
+        this->queueCommand(poll);
+        this->lastFanQuery_ = millis();
+      }
+
+      if ((this->commandCount_ > 0) && (this->rfState_ == RfStateIdle)) {
+        this->dispatchCommand();
+      }
+      // Nothing outstanding: let the radio rest, and have it settled by the time the next poll is due
+      else if (this->rfState_ == RfStateIdle) {
+        if ((millis() - this->lastFanQuery_) >=
+            (this->pollInterval_ - std::min(this->pollInterval_, (uint32_t) FAN_WAKE_AHEAD))) {
+          this->rf_->wake();
+        } else {
+          this->rf_->sleep();
+        }
       }
       break;
 
@@ -218,6 +320,45 @@ void ZehnderRF::loop(void) {
   }
 }
 
+// Drain the radio's RX queue. Runs from loop() only, so handlers are free to start a new transmit.
+void ZehnderRF::rfDispatchReceived(void) {
+  nrf905::RxQueue<NRF905_RX_QUEUE_SIZE> &queue = this->rf_->getRxQueue();
+  const nrf905::RxFrame *frame;
+
+  while ((frame = queue.front()) != nullptr) {
+    ESP_LOGV(TAG, "nRF905: RX Complete (queued %u ms)", millis() - frame->time);
+    this->rxTime_ = frame->time;
+    if ((frame->length >= sizeof(RfFrame)) && this->rfIsDuplicate((const RfFrame *) frame->data, frame->time)) {
+      ESP_LOGV(TAG, "Dropped retransmitted copy of cmd 0x%02X", ((const RfFrame *) frame->data)->command);
+      ++this->linkStats_.duplicates;
+    } else {
+      this->rfHandleReceived(frame->data, frame->length);
+    }
+    queue.pop();
+  }
+}
+
+// Every frame goes out FAN_TX_FRAMES times, only the first copy is handled. Copies are identical, source included.
+bool ZehnderRF::rfIsDuplicate(const RfFrame *const frame, const uint32_t time) {
+  if (this->dedupWindow_ == 0) {
+    return false;
+  }
+
+  for (auto &entry : this->dedupCache_) {
+    if (entry.valid && ((time - entry.time) < this->dedupWindow_) &&
+        (memcmp(&entry.frame, frame, sizeof(RfFrame)) == 0)) {
+      entry.time = time; // Window runs from the last copy, so a whole train of copies is dropped
+      return true;
+    }
+  }
+
+  (void) memcpy(&this->dedupCache_[this->dedupNext_].frame, frame, sizeof(RfFrame));
+  this->dedupCache_[this->dedupNext_].time = time;
+  this->dedupCache_[this->dedupNext_].valid = true;
+  this->dedupNext_ = (this->dedupNext_ + 1) % FAN_DEDUP_CACHE_SIZE;
+  return false;
+}
+
 // Handle Received RF Data
 void ZehnderRF::rfHandleReceived(const uint8_t *const pData, const uint8_t dataLength) {
   if (dataLength < sizeof(RfFrame)) { // Basic sanity check
@@ -226,9 +367,16 @@ void ZehnderRF::rfHandleReceived(const uint8_t *const pData, const uint8_t dataL
   }
   const RfFrame *frame = (const RfFrame *) pData;
 
-  ESP_LOGD(TAG, "Received Frame in State %d. Cmd: 0x%02X, From: %02X:%02X, To: %02X:%02X, Data: %s", 
-           this->state_, frame->command, frame->tx_type, frame->tx_id, frame->rx_type, frame->rx_id, 
-           bytes_to_hex(pData, dataLength).c_str());
+  ZEHNDER_TRACE(nrf905::TraceFrameDispatch, this->state_, pData, dataLength);
+  ESP_LOGD(TAG, "Received Frame in State %d. Cmd: 0x%02X, From: %02X:%02X, To: %02X:%02X",
+           this->state_, frame->command, frame->tx_type, frame->tx_id, frame->rx_type, frame->rx_id);
+
+  if (this->observeFrame(frame)) {
+    return; // Between other devices, whatever we are waiting for
+  }
+  if ((this->config_.fan_networkId != 0) && (this->state_ >= StateIdle) && !this->fromMainUnit(frame)) {
+    ++this->linkStats_.unknownSource;
+  }
 
   // State-specific handling
   switch (this->state_) {
@@ -238,6 +386,7 @@ void ZehnderRF::rfHandleReceived(const uint8_t *const pData, const uint8_t dataL
         this->handleDiscoveryLinkRequest(frame);
       } else {
         ESP_LOGW(TAG, "Discovery (WaitLink): Received unexpected cmd 0x%02X", frame->command);
+        ++this->linkStats_.unexpected;
       }
       break;
 
@@ -247,6 +396,7 @@ void ZehnderRF::rfHandleReceived(const uint8_t *const pData, const uint8_t dataL
         this->handleDiscoveryJoinResponse(frame);
       } else {
         ESP_LOGW(TAG, "Discovery (WaitJoin): Received unexpected cmd 0x%02X", frame->command);
+        ++this->linkStats_.unexpected;
       }
       break;
 
@@ -256,6 +406,7 @@ void ZehnderRF::rfHandleReceived(const uint8_t *const pData, const uint8_t dataL
         this->handleDiscoveryJoinComplete(frame);
       } else {
         ESP_LOGW(TAG, "Discovery (JoinComplete): Received unexpected cmd 0x%02X", frame->command);
+        ++this->linkStats_.unexpected;
       }
       break;
 
@@ -263,11 +414,26 @@ void ZehnderRF::rfHandleReceived(const uint8_t *const pData, const uint8_t dataL
       ESP_LOGV(TAG, "Handling received frame in StateWaitFanSettings");
       if (frame->command == FAN_TYPE_FAN_SETTINGS) {
         this->handleFanSettings(frame);
+        this->logQueryCost(true);
+        this->linkAnswered();
         this->state_ = StateIdle; // Got response, return to idle
         this->rfState_ = RfStateIdle;
         this->rfComplete(); // Mark RF layer as idle too
+        this->completeCommand(CommandDone);
       } else {
         ESP_LOGD(TAG, "WaitFanSettings: Received other cmd 0x%02X while waiting for 0x07", frame->command);
+        ++this->linkStats_.unexpected;
+      }
+      break;
+
+    case StateWaitSetSpeedReply: // Expecting SETSPEED_REPLY (0x05) or SETVOLTAGE_REPLY (0x1D), or FAN_SETTINGS (0x07)
+      ESP_LOGV(TAG, "Handling received frame in StateWaitSetSpeedReply");
+      if ((frame->command == FAN_FRAME_SETSPEED_REPLY) || (frame->command == FAN_FRAME_SETVOLTAGE_REPLY) ||
+          (frame->command == FAN_TYPE_FAN_SETTINGS)) {
+        this->handleSetSpeedReply(frame);
+      } else {
+        ESP_LOGD(TAG, "WaitSetSpeedReply: Received other cmd 0x%02X while waiting for 0x05", frame->command);
+        ++this->linkStats_.unexpected;
       }
       break;
 
@@ -287,6 +453,7 @@ void ZehnderRF::rfHandleReceived(const uint8_t *const pData, const uint8_t dataL
     case StateWaitSetSpeedConfirm:
     default:
       ESP_LOGD(TAG, "Received frame ignored in current state (%d).", this->state_);
+      ++this->linkStats_.unexpected;
       break;
   }
 }
@@ -310,8 +477,11 @@ void ZehnderRF::handleDiscoveryLinkRequest(const RfFrame *const frame) {
   nrf905::Config rfConfig = this->rf_->getConfig();
   rfConfig.rx_address = this->config_.fan_networkId;
   rfConfig.auto_retransmit = true;
-  this->rf_->updateConfig(&rfConfig);
-  this->rf_->writeTxAddress(this->config_.fan_networkId);
+  {
+    nrf905::nRF905Transaction transaction(this->rf_);
+    this->rf_->updateConfig(&rfConfig);
+    this->rf_->writeTxAddress(this->config_.fan_networkId);
+  }
 
   RfFrame txFrame;
   memset(&txFrame, 0, sizeof(RfFrame));
@@ -341,7 +511,7 @@ void ZehnderRF::handleDiscoveryJoinResponse(const RfFrame *const frame) {
     RfFrame txFrame;
     if ((frame->rx_type == FAN_TYPE_REMOTE_CONTROL) && (frame->rx_id == this->config_.fan_my_device_id) &&
         (frame->tx_type == FAN_TYPE_MAIN_UNIT) && (frame->tx_id == this->config_.fan_main_unit_id)) {
-        ESP_LOGI(TAG, "Discovery Step 2: Received Join ACK (0x0B) from Main Unit. Sending Final ACK (0x0B)...", frame->tx_id);
+        ESP_LOGI(TAG, "Discovery Step 2: Received Join ACK (0x0B) from Main Unit 0x%02X. Sending Final ACK (0x0B)...", frame->tx_id);
         this->rfComplete();
         memset(&txFrame, 0, sizeof(RfFrame));
         txFrame.rx_type = FAN_TYPE_MAIN_UNIT;
@@ -380,7 +550,7 @@ void ZehnderRF::handleDiscoveryJoinComplete(const RfFrame *const frame) {
             ESP_LOGE(TAG, "Failed to save pairing configuration to flash!");
         }
         this->state_ = StateIdle;
-        this->lastFanQuery_ = millis() - this->interval_ + 500;
+        this->lastFanQuery_ = millis() - this->pollInterval_ + 500;
     } else {
         ESP_LOGW(TAG, "Discovery (JoinComplete): Received 0x0D with mismatched ID/Type. RX_T:%02X RX_ID:%02X TX_T:%02X TX_ID:%02X",
                   frame->rx_type, frame->rx_id, frame->tx_type, frame->tx_id);
@@ -392,23 +562,231 @@ void ZehnderRF::handleFanSettings(const RfFrame *const frame) {
       ESP_LOGW(TAG,"Received Fan Settings from unexpected source (%02X:%02X). Ignoring.", frame->tx_type, frame->tx_id);
       return;
   }
+  if (this->startupTime_ == 0) {
+    this->startupTime_ = std::max(this->rxTime_, (uint32_t) 1);
+    ESP_LOGI(TAG, "First fan status %u ms after boot", this->startupTime_);
+    if (this->startup_time_sensor_ != nullptr) {
+      this->startup_time_sensor_->publish_state(this->startupTime_);
+    }
+  }
   const RfPayloadFanSettings *settings = &frame->payload.fanSettings;
   ESP_LOGD(TAG, "Received Fan Settings - Speed: 0x%02X, Voltage: %u%%, Timer: %u",
            settings->speed, settings->voltage, settings->timer);
-  this->speed = settings->speed;
-  this->state = (this->speed > FAN_SPEED_AUTO);
-  this->voltage = settings->voltage;
-  this->timer = (settings->timer != 0);
-  this->publish_state();
-  if (this->ventilation_percentage_sensor_ != nullptr) {
-    this->ventilation_percentage_sensor_->publish_state(this->voltage);
+  this->publishSnapshot({settings->speed, settings->voltage, settings->timer, true, true, millis()});
+  this->setStateConfirmed(true);
+  if (this->observedPending_) {
+    this->observedPending_ = false; // The unit's own view settles it
+    this->cancel_timeout("observe");
   }
-  if (this->timer_binary_sensor_ != nullptr) {
-    this->timer_binary_sensor_->publish_state(this->timer);
+  this->pollSample(settings);
+}
+
+// Paired, the radio hears every frame on the network. Commands from other remotes (wall switches) and the unit's
+// acknowledgements to them tell the fan state without polling: a command alone is published unconfirmed, and
+// polled for if no acknowledgement follows.
+bool ZehnderRF::observeFrame(const RfFrame *const frame) {
+  if ((this->config_.fan_networkId == 0) || (this->state_ < StateIdle)) {
+    return false;
   }
-  if (this->ventilation_mode_text_sensor_ != nullptr) {
-    this->ventilation_mode_text_sensor_->publish_state(this->speedToMode_(this->speed));
+  const bool forUs = (frame->rx_type == this->config_.fan_my_device_type) &&
+                     (frame->rx_id == this->config_.fan_my_device_id);
+  const bool fromUs = (frame->tx_type == this->config_.fan_my_device_type) &&
+                      (frame->tx_id == this->config_.fan_my_device_id);
+
+  if (((frame->command == FAN_FRAME_SETSPEED) || (frame->command == FAN_FRAME_SETTIMER)) && !fromUs &&
+      (frame->rx_type == this->config_.fan_main_unit_type) && (frame->rx_id == this->config_.fan_main_unit_id)) {
+    if (!this->passiveTracking_) {
+      return true; // Left to the next poll
+    }
+    this->observed_.type = frame->tx_type;
+    this->observed_.id = frame->tx_id;
+    if (frame->command == FAN_FRAME_SETSPEED) {
+      this->observed_.speed = frame->payload.setSpeed.speed;
+      this->observed_.timer = 0;
+    } else {
+      this->observed_.speed = frame->payload.setTimer.speed;
+      this->observed_.timer = frame->payload.setTimer.timer;
+    }
+    ESP_LOGD(TAG, "Observed %02X:%02X setting speed %u (timer %u)", frame->tx_type, frame->tx_id,
+             this->observed_.speed, this->observed_.timer);
+    this->observedPending_ = true;
+    this->publishSpeed(this->observed_.speed, this->observed_.timer);
+    this->setStateConfirmed(false);
+    this->set_timeout("observe", FAN_OBSERVE_TIMEOUT, [this]() {
+      ESP_LOGD(TAG, "Observed command not acknowledged, polling.");
+      this->observedPending_ = false;
+      this->lastFanQuery_ = millis() - this->pollInterval_;
+    });
+    return true;
   }
+
+  if ((frame->command == FAN_FRAME_SETSPEED_REPLY) && !forUs && this->fromMainUnit(frame)) {
+    if (this->observedPending_ && (frame->rx_type == this->observed_.type) && (frame->rx_id == this->observed_.id)) {
+      ESP_LOGD(TAG, "Observed speed %u acknowledged by the unit", this->observed_.speed);
+      this->observedPending_ = false;
+      this->cancel_timeout("observe");
+      this->setStateConfirmed(true);
+      // As good as a fresh sample of a change
+      this->pollInterval_ = this->interval_;
+      this->lastChange_ = millis();
+      this->lastFanQuery_ = millis();
+    }
+    return true;
+  }
+
+  return false;
+}
+
+void ZehnderRF::publishVoltage(const uint8_t voltage) {
+  FanSnapshot next = this->snapshot_;
+
+  next.voltage = voltage;
+  next.hasVoltage = true;
+  next.fromUnit = false;
+  next.updated = millis();
+  this->publishSnapshot(next);
+}
+
+void ZehnderRF::publishSpeed(const uint8_t speed, const uint8_t timer) {
+  FanSnapshot next = this->snapshot_; // The voltage that goes with the new speed is unknown until the next poll
+
+  next.speed = speed;
+  next.timer = timer;
+  next.fromUnit = false;
+  next.updated = millis();
+  this->publishSnapshot(next);
+}
+
+// Only fields that changed are published: every poll used to republish all of them, identical or not. A voltage
+// must move more than the deadband, and with a heartbeat interval a sample republishes everything when it's due.
+void ZehnderRF::publishSnapshot(const FanSnapshot &next) {
+  const FanSnapshot last = this->snapshot_;
+  const bool all = !this->snapshotPublished_ ||
+                   ((this->heartbeatInterval_ != 0) && ((next.updated - this->lastHeartbeat_) >= this->heartbeatInterval_));
+
+  const bool percentage = (this->speedControl_ == SpeedControlPercentage);
+
+  bool fanState = (next.speed > FAN_SPEED_AUTO);
+  int fanSpeed = next.speed;
+
+  if (percentage) {
+    // The fan entity shows the voltage, off being the Auto preset; a preset alone doesn't tell it
+    fanState = next.hasVoltage ? (fanState || (next.voltage > 0)) : this->state;
+    fanSpeed = next.hasVoltage ? std::max(next.voltage, (uint8_t) 1) : this->speed;
+  }
+
+  this->snapshot_ = next;
+  this->voltage = next.voltage;
+  if (next.hasVoltage && (next.voltage > 0)) {
+    this->lastVoltage_ = std::min(next.voltage, (uint8_t) FAN_PERCENTAGE_STEPS);
+  }
+  this->timer = (next.timer != 0);
+  if (all) {
+    this->snapshotPublished_ = true;
+    this->lastHeartbeat_ = next.updated;
+  }
+
+  if (all || (fanState != this->state) || (fanSpeed != this->speed)) {
+    this->state = fanState;
+    this->speed = fanSpeed;
+    this->publish_state();
+  }
+  if ((this->ventilation_mode_text_sensor_ != nullptr) && (all || (next.speed != last.speed))) {
+    this->ventilation_mode_text_sensor_->publish_state(this->speedToMode_(next.speed));
+  }
+  if ((this->timer_binary_sensor_ != nullptr) && (all || ((next.timer != 0) != (last.timer != 0)))) {
+    this->timer_binary_sensor_->publish_state(next.timer != 0);
+  }
+  if ((this->ventilation_percentage_sensor_ != nullptr) && next.hasVoltage &&
+      (all || (this->publishedVoltage_ < 0) || (abs(next.voltage - this->publishedVoltage_) > this->voltageDeadband_))) {
+    this->ventilation_percentage_sensor_->publish_state(next.voltage);
+    this->publishedVoltage_ = next.voltage;
+  }
+}
+
+void ZehnderRF::setStateConfirmed(const bool confirmed) {
+  this->stateConfirmed_ = confirmed;
+  if (this->state_confirmed_binary_sensor_ != nullptr) {
+    this->state_confirmed_binary_sensor_->publish_state(confirmed);
+  }
+}
+
+// Any valid settings frame, asked for or not, counts as a poll. Poll fast while things change, and after that at
+// intervals as long as the settings have been stable: the interval doubles on every unchanged poll, and repeats
+// or unsolicited frames in between don't make it grow any faster.
+void ZehnderRF::pollSample(const RfPayloadFanSettings *const settings) {
+  const uint32_t now = millis();
+  const bool changed = !this->haveSettings_ || (settings->speed != this->lastSettings_.speed) ||
+                       (settings->voltage != this->lastSettings_.voltage) ||
+                       ((settings->timer != 0) != (this->lastSettings_.timer != 0));
+
+  if (changed) {
+    this->lastChange_ = now;
+  }
+  this->pollInterval_ = std::min(std::max(now - this->lastChange_, this->interval_), this->maxInterval_);
+  // A running timer ends with a speed change, don't sleep through it
+  if (settings->timer != 0) {
+    this->pollInterval_ = std::max(this->interval_, std::min(this->pollInterval_, (uint32_t) settings->timer * 60000));
+  }
+
+  this->lastSettings_ = *settings;
+  this->haveSettings_ = true;
+  this->lastFanQuery_ = now;
+  ESP_LOGD(TAG, "Settings %s, next poll in %u s", changed ? "changed" : "unchanged", this->pollInterval_ / 1000);
+}
+
+bool ZehnderRF::fromMainUnit(const RfFrame *const frame) {
+  return (frame->tx_type == this->config_.fan_main_unit_type) && (frame->tx_id == this->config_.fan_main_unit_id);
+}
+
+void ZehnderRF::handleSetSpeedReply(const RfFrame *const frame) {
+  const bool voltage = (this->activeCommand_.type == CommandSetVoltage);
+  const uint8_t acknowledge = voltage ? FAN_FRAME_SETVOLTAGE_REPLY : FAN_FRAME_SETSPEED_REPLY;
+
+  // The acknowledgement is addressed to us; settings may also come as a broadcast
+  if (!this->fromMainUnit(frame) ||
+      ((frame->command != FAN_TYPE_FAN_SETTINGS) && ((frame->command != acknowledge) ||
+                                                      (frame->rx_type != this->config_.fan_my_device_type) ||
+                                                      (frame->rx_id != this->config_.fan_my_device_id)))) {
+    ESP_LOGD(TAG, "WaitSetSpeedReply: 0x%02X from %02X:%02X to %02X:%02X is not for us", frame->command,
+             frame->tx_type, frame->tx_id, frame->rx_type, frame->rx_id);
+    return;
+  }
+  // Anything before our frame went out, or settings still showing the old value, is from before the change
+  if ((this->rfState_ != RfStateRxWait) ||
+      ((frame->command == FAN_TYPE_FAN_SETTINGS) &&
+       (voltage ? (frame->payload.fanSettings.voltage != this->activeCommand_.voltage)
+                : (frame->payload.fanSettings.speed != this->activeCommand_.speed)))) {
+    ESP_LOGD(TAG, "WaitSetSpeedReply: stale 0x%02X, still waiting", frame->command);
+    return;
+  }
+
+  const uint32_t latency = millis() - this->activeCommand_.queued;
+  if (voltage) {
+    ESP_LOGD(TAG, "Voltage %u%% confirmed by 0x%02X after %u ms", this->activeCommand_.voltage, frame->command,
+             latency);
+  } else {
+    ESP_LOGD(TAG, "Speed %u confirmed by 0x%02X after %u ms", this->activeCommand_.speed, frame->command, latency);
+  }
+
+  if (frame->command == FAN_TYPE_FAN_SETTINGS) {
+    this->handleFanSettings(frame); // The unit's own view, voltage included
+  } else {
+    if (voltage) {
+      this->publishVoltage(this->activeCommand_.voltage);
+    } else {
+      this->publishSpeed(this->activeCommand_.speed, this->activeCommand_.timer);
+    }
+    this->setStateConfirmed(true);
+  }
+  if (this->confirmation_latency_sensor_ != nullptr) {
+    this->confirmation_latency_sensor_->publish_state(latency);
+  }
+
+  this->linkAnswered();
+  this->state_ = StateIdle;
+  this->rfComplete();
+  this->completeCommand(CommandDone);
 }
 
 // Helper: Convert speed preset to text mode
@@ -423,10 +801,17 @@ std::string ZehnderRF::speedToMode_(uint8_t speed_preset) {
     }
 }
 
+bool ZehnderRF::pairingValid(void) {
+  return (this->config_.fan_networkId != 0) && (this->config_.fan_networkId != NETWORK_LINK_ID) &&
+         (this->config_.fan_my_device_type == FAN_TYPE_REMOTE_CONTROL) && (this->config_.fan_my_device_id != 0) &&
+         (this->config_.fan_my_device_id != 0xFF) && (this->config_.fan_main_unit_type == FAN_TYPE_MAIN_UNIT) &&
+         (this->config_.fan_main_unit_id != 0) && (this->config_.fan_main_unit_id != 0xFF);
+}
+
 // Generate a unique-ish device ID based on MAC
 uint8_t ZehnderRF::createDeviceID(void) {
-  // Correct way to get MAC address string
-  std::string mac_address = esphome::network::get_mac_address();
+  // MAC address string, the last byte becomes our device ID
+  std::string mac_address = get_mac_address();
   ESP_LOGV(TAG, "Using MAC address for ID: %s", mac_address.c_str());
   // Extract the last byte (two hex characters)
   std::string last_byte_str = mac_address.substr(mac_address.length() - 2, 2);
@@ -435,11 +820,44 @@ uint8_t ZehnderRF::createDeviceID(void) {
   return clamp(id, 1, 254); // Avoid 0x00 and 0xFF
 }
 
+// Queue Speed/Timer Command
+void ZehnderRF::setSpeed(const uint8_t speed, const uint8_t timer, const CommandCallback callback) {
+  Command command{};
+
+  command.type = CommandSetSpeed;
+  command.priority = CommandPriorityUser;
+  command.speed = speed;
+  command.timer = timer;
+  command.callback = callback;
+  this->queueCommand(command);
+}
+
+// Queue Voltage Command
+void ZehnderRF::setVoltage(const uint8_t voltage, const CommandCallback callback) {
+  Command command{};
+
+  command.type = CommandSetVoltage;
+  command.priority = CommandPriorityUser;
+  command.voltage = std::min(voltage, (uint8_t) 100);
+  command.callback = callback;
+  this->queueCommand(command);
+}
+
+// Queue Link Probe
+void ZehnderRF::probeLink(const CommandCallback callback) {
+  Command command{};
+
+  command.type = CommandQuery;
+  command.priority = CommandPriorityDiagnostic;
+  command.callback = callback;
+  this->queueCommand(command);
+}
+
 // Send Speed/Timer Command
-void ZehnderRF::setSpeed(const uint8_t paramSpeed, const uint8_t paramTimer) {
+Result ZehnderRF::sendSpeed(const uint8_t paramSpeed, const uint8_t paramTimer) {
   if (this->config_.fan_networkId == 0) { // Don't send commands if not paired
       ESP_LOGW(TAG, "Cannot set speed: Not paired.");
-      return;
+      return ResultFailure;
   }
   const uint8_t speed_clamped = clamp(paramSpeed, FAN_SPEED_AUTO, FAN_SPEED_MAX);
   ESP_LOGD(TAG, "Sending Set Speed/Timer command - Speed: %u, Timer: %u", speed_clamped, paramTimer);
@@ -462,24 +880,56 @@ void ZehnderRF::setSpeed(const uint8_t paramSpeed, const uint8_t paramTimer) {
     frame.payload.setTimer.speed = speed_clamped;
     frame.payload.setTimer.timer = paramTimer;
   }
+  return this->sendFanCommand(&frame);
+}
 
-  // Send the frame, no reply expected according to some traces, just TX confirmation needed.
-  // Use -1 for retries to indicate no reply needed.
-  Result result = this->startTransmit((uint8_t *) &frame, -1);
+// Send Voltage Command
+Result ZehnderRF::sendVoltage(const uint8_t voltage) {
+  if (this->config_.fan_networkId == 0) { // Don't send commands if not paired
+      ESP_LOGW(TAG, "Cannot set voltage: Not paired.");
+      return ResultFailure;
+  }
+  ESP_LOGD(TAG, "Sending Set Voltage command - Voltage: %u%%", voltage);
+
+  RfFrame frame;
+  memset(&frame, 0, sizeof(RfFrame));
+  frame.rx_type = this->config_.fan_main_unit_type;
+  frame.rx_id = this->config_.fan_main_unit_id;
+  frame.tx_type = this->config_.fan_my_device_type;
+  frame.tx_id = this->config_.fan_my_device_id;
+  frame.ttl = FAN_TTL;
+  frame.command = FAN_FRAME_SETVOLTAGE;
+  frame.parameter_count = sizeof(RfPayloadFanSetVoltage);
+  frame.payload.setVoltage.voltage = voltage;
+  return this->sendFanCommand(&frame);
+}
+
+Result ZehnderRF::sendFanCommand(RfFrame *const frame) {
+  // Confirmed: wait for the unit's 0x05/0x1D (or 0x07) and retransmit only while it is missing.
+  // Otherwise no reply is awaited, just TX confirmation; the callback then only fires if channel access fails.
+  Result result = this->startTransmit(
+      (uint8_t *) frame, this->confirmCommands_ ? this->retryBudget() : -1,
+      [this]() {
+        ESP_LOGW(TAG, "Speed change not acknowledged.");
+        this->state_ = StateIdle;
+        this->lastFanQuery_ = millis() - this->pollInterval_; // Find out what the unit is doing now
+        this->completeCommand(CommandFailed);
+      },
+      TxPriorityCommand, this->replyTimeout());
   if (result == ResultOk) {
-    this->state_ = StateWaitSetSpeedConfirm; // Wait for TX confirmation
+    // Wait for the acknowledgement, or just for TX confirmation
+    this->state_ = this->confirmCommands_ ? StateWaitSetSpeedReply : StateWaitSetSpeedConfirm;
   } else {
-    ESP_LOGW(TAG, "Failed to start transmit for setSpeed. RF state: %d", this->rfState_);
-    // If busy, the pending setting flag (`newSetting`) should still be true,
-    // so loop() will try again later.
+    ESP_LOGW(TAG, "Failed to start transmit for command 0x%02X. RF state: %d", frame->command, this->rfState_);
   }
+  return result;
 }
 
 // Send Device Status Query Command
-void ZehnderRF::queryDevice(void) {
+Result ZehnderRF::queryDevice(void) {
   if (this->config_.fan_networkId == 0) { // Don't send commands if not paired
       ESP_LOGW(TAG, "Cannot query device: Not paired.");
-      return;
+      return ResultFailure;
   }
   ESP_LOGD(TAG, "Sending Query Device command (0x10)...");
 
@@ -494,16 +944,119 @@ void ZehnderRF::queryDevice(void) {
   frame.parameter_count = 0;
 
   // Send the frame, expect FAN_SETTINGS (0x07) reply
-  Result result = this->startTransmit((uint8_t *) &frame, FAN_TX_RETRIES, [this]() {
+  Result result = this->startTransmit((uint8_t *) &frame, this->retryBudget(), [this]() {
     ESP_LOGW(TAG, "Timeout waiting for Fan Settings (0x07) reply.");
+    this->logQueryCost(false);
     this->state_ = StateIdle; // Return to idle on timeout
-  });
+    this->completeCommand(CommandFailed);
+  }, TxPriorityPoll, this->replyTimeout());
 
   if (result == ResultOk) {
+    this->queryStart_ = this->rf_->getStats();
     this->state_ = StateWaitFanSettings; // Wait for the reply
+  } else if (result == ResultDeferred) {
+    ESP_LOGD(TAG, "Airtime budget low, skipping this poll.");
   } else {
     ESP_LOGW(TAG, "Failed to start transmit for queryDevice. RF state: %d", this->rfState_);
   }
+  return result;
+}
+
+void ZehnderRF::queueCommand(Command command) {
+  command.queued = millis();
+
+  for (uint8_t i = 0; i < this->commandCount_; ++i) {
+    Command *const queued = &this->commandQueue_[i];
+
+    // Speed and voltage both set what the fan does, either replaces the other
+    if ((queued->type != command.type) && ((queued->type == CommandQuery) || (command.type == CommandQuery))) {
+      continue;
+    }
+    queued->priority = std::max(queued->priority, command.priority);
+    if (command.type != CommandQuery) {
+      // Only the latest target matters
+      ESP_LOGD(TAG, "Fan command superseded before it was sent.");
+      CommandCallback superseded = std::move(queued->callback);
+      queued->type = command.type;
+      queued->speed = command.speed;
+      queued->timer = command.timer;
+      queued->voltage = command.voltage;
+      queued->queued = command.queued;
+      queued->callback = std::move(command.callback);
+      if (superseded != nullptr) {
+        superseded(CommandSuperseded);
+      }
+    } else if (command.callback != nullptr) {
+      // One query answers everyone waiting for it
+      if (queued->callback == nullptr) {
+        queued->callback = std::move(command.callback);
+      } else {
+        queued->callback = [first = std::move(queued->callback), second = std::move(command.callback)](
+                               const CommandResult result) {
+          first(result);
+          second(result);
+        };
+      }
+    }
+    return;
+  }
+
+  // Nothing of this kind queued, so there is a free slot: the queue holds one of each
+  this->commandQueue_[this->commandCount_++] = std::move(command);
+}
+
+void ZehnderRF::dispatchCommand(void) {
+  uint8_t next = 0;
+  Result result;
+
+  for (uint8_t i = 1; i < this->commandCount_; ++i) {
+    if (this->commandQueue_[i].priority > this->commandQueue_[next].priority) {
+      next = i;
+    }
+  }
+
+  this->activeCommand_ = std::move(this->commandQueue_[next]);
+  std::move(&this->commandQueue_[next + 1], &this->commandQueue_[this->commandCount_], &this->commandQueue_[next]);
+  --this->commandCount_;
+  this->commandActive_ = true;
+  ESP_LOGV(TAG, "Dispatching command %u after %u ms in the queue.", this->activeCommand_.type,
+           millis() - this->activeCommand_.queued);
+
+  if (this->activeCommand_.type != CommandQuery) {
+    this->pollInterval_ = this->interval_; // Follow up on the change quickly
+    this->lastChange_ = millis();
+  }
+  if (this->activeCommand_.type == CommandSetSpeed) {
+    result = this->sendSpeed(this->activeCommand_.speed, this->activeCommand_.timer);
+  } else if (this->activeCommand_.type == CommandSetVoltage) {
+    result = this->sendVoltage(this->activeCommand_.voltage);
+  } else {
+    result = this->queryDevice();
+  }
+  if (result != ResultOk) {
+    this->completeCommand(CommandFailed);
+  }
+}
+
+void ZehnderRF::completeCommand(const CommandResult result) {
+  if (!this->commandActive_) {
+    return;
+  }
+  this->commandActive_ = false;
+
+  // The callback may queue the next command
+  CommandCallback callback = std::move(this->activeCommand_.callback);
+  this->activeCommand_.callback = nullptr;
+  if (callback != nullptr) {
+    callback(result);
+  }
+}
+
+void ZehnderRF::logQueryCost(const bool answered) {
+  const nrf905::RadioStats &stats = this->rf_->getStats();
+
+  ESP_LOGD(TAG, "Query %s: %u transmissions, %u us on air", answered ? "answered" : "unanswered",
+           stats.txStarted - this->queryStart_.txStarted, (uint32_t) (stats.airtime - this->queryStart_.airtime));
 }
 
 // Start Discovery Process
@@ -518,8 +1071,11 @@ void ZehnderRF::discoveryStart(const uint8_t deviceId) {
   nrf905::Config rfConfig = this->rf_->getConfig();
   rfConfig.rx_address = NETWORK_LINK_ID;
   rfConfig.auto_retransmit = false; // No retransmit for broadcast
-  this->rf_->updateConfig(&rfConfig);
-  this->rf_->writeTxAddress(NETWORK_LINK_ID);
+  {
+    nrf905::nRF905Transaction transaction(this->rf_);
+    this->rf_->updateConfig(&rfConfig);
+    this->rf_->writeTxAddress(NETWORK_LINK_ID);
+  }
 
   // Prepare Discovery Broadcast Frame (JOIN_REQUEST 0x04)
   RfFrame frame;
@@ -549,27 +1105,63 @@ void ZehnderRF::discoveryStart(const uint8_t deviceId) {
 
 // Initiate RF Transmission
 Result ZehnderRF::startTransmit(const uint8_t *const pData, const int8_t rxRetries,
-                                const std::function<void(void)> timeoutCallback) {
+                                const std::function<void(void)> timeoutCallback, const TxPriority priority,
+                                const uint32_t replyTimeout) {
   if (this->rfState_ != RfStateIdle) {
     ESP_LOGW(TAG, "Cannot start transmit: RF layer busy (State: %d)", this->rfState_);
     return ResultBusy;
   }
 
-  ESP_LOGV(TAG, "Starting transmit. Retries=%d, Data: %s", rxRetries, bytes_to_hex(pData, FAN_FRAMESIZE).c_str());
+  // Polls don't wait for budget, the next interval brings a fresh one
+  if ((priority == TxPriorityPoll) && !this->dutyAllows(TxPriorityPoll)) {
+    ++this->dutyStats_.deferredPolls;
+    return ResultDeferred;
+  }
+
+  ZEHNDER_TRACE(nrf905::TraceFrameTransmit, rxRetries, pData, FAN_FRAMESIZE);
+  ESP_LOGV(TAG, "Starting transmit. Retries=%d, Cmd: 0x%02X", rxRetries, ((const RfFrame *) pData)->command);
   this->onReceiveTimeout_ = timeoutCallback;
   this->retries_ = rxRetries;
+  this->txRetries_ = rxRetries;
+  this->txPriority_ = priority;
+  if (rxRetries >= 0) {
+    ++this->linkStats_.transactions;
+  }
+  this->replyTimeout_ = replyTimeout;
+  this->linkTracked_ = (this->state_ >= StateIdle); // Discovery talks to whoever answers on the link address
+  this->retransmitted_ = false;
 
   this->rf_->writeTxPayload(pData, FAN_FRAMESIZE);
 
-  // Move to wait for airway clear state
-  this->rfState_ = RfStateWaitAirwayFree;
-  this->airwayFreeWaitTime_ = millis();
+  this->rfAccess();
   return ResultOk;
 }
 
+void ZehnderRF::rfAccess(void) {
+  if (this->dutyAllows(this->txPriority_)) {
+    // Move to wait for airway clear state
+    this->airwayFreeWaitTime_ = millis();
+    this->csmaStart();
+  } else {
+    ESP_LOGD(TAG, "Airtime budget exhausted, holding transmission.");
+    ++this->dutyStats_.deferredCommands;
+    this->dutyWaitTime_ = millis();
+    this->rfState_ = RfStateWaitBudget;
+  }
+}
+
 // Mark RF Transmission/Reception Cycle as Complete
 void ZehnderRF::rfComplete(void) {
   ESP_LOGV(TAG, "Marking RF cycle complete.");
+  if (this->retries_ >= 0) {
+    const uint32_t latency = this->rxTime_ - this->msgSendTime_;
+
+    ++this->csmaStats_.answered;
+    this->csmaWindow_ = this->csmaMinWindow_;
+    this->linkStats_.totalLatency += latency;
+    ++this->linkStats_.replyLatency[histogramBucket(latency, 25)];
+    this->linkFinished(true);
+  }
   this->retries_ = -1; // No more retries needed
   this->rfState_ = RfStateIdle;
   // Do not change the main state_ here, let the calling function do that.
@@ -582,22 +1174,37 @@ void ZehnderRF::rfHandler(void) {
       // Nothing to do
       break;
 
-    case RfStateWaitAirwayFree:
-      // Check if airway is clear or timeout waiting
-      if ((millis() - this->airwayFreeWaitTime_) > 5000) { // 5 second timeout for airway clear
-        ESP_LOGW(TAG, "Airway busy timeout! Aborting TX.");
-        if (this->onReceiveTimeout_ != nullptr) {
-          this->onReceiveTimeout_(); // Trigger timeout callback
+    case RfStateWaitAirwayFree: {
+      const uint32_t now = millis();
+
+      // The backoff only counts down while the channel is clear, a busy channel freezes it
+      if (this->rf_->airwayBusy()) {
+        if (this->csmaClear_) {
+          this->csmaBackoff_ -= std::min(this->csmaBackoff_, now - this->csmaClearSince_);
+          this->csmaClear_ = false;
+          ++this->csmaStats_.deferrals;
         }
-        this->rfState_ = RfStateIdle; // Give up
-      } else if (!this->rf_->airwayBusy()) {
+      } else if (!this->csmaClear_) {
+        this->csmaClear_ = true;
+        this->csmaClearSince_ = now;
+      }
+
+      if (this->csmaClear_ && ((now - this->csmaClearSince_) >= this->csmaBackoff_)) {
         ESP_LOGV(TAG, "Airway clear. Starting TX...");
-        // Expect reply? Then set next mode to Receive. No reply? Set next mode to Idle.
-        nrf905::Mode next_mode = (this->retries_ >= 0) ? nrf905::Receive : nrf905::Idle;
-        this->rf_->startTx(FAN_TX_FRAMES, next_mode);
-        this->rfState_ = RfStateTxBusy;
+        this->csmaTransmit(now);
+      } else if ((now - this->airwayFreeWaitTime_) > this->csmaTimeout_) {
+        ++this->csmaStats_.aborts;
+        if (this->csmaAbort_ == CsmaAbortTransmit) {
+          ESP_LOGW(TAG, "Airway busy timeout! Transmitting anyway.");
+          this->csmaTransmit(now);
+        } else {
+          ESP_LOGW(TAG, "Airway busy timeout! Aborting TX.");
+          this->highFreq_.stop();
+          this->rfFail(); // Give up
+        }
       }
       break;
+    }
 
     case RfStateTxBusy:
       // Waiting for the OnTxReady callback from nRF905 component
@@ -605,31 +1212,339 @@ void ZehnderRF::rfHandler(void) {
 
     case RfStateRxWait:
       // Waiting for OnRxComplete callback, or timeout
-      if ((this->retries_ >= 0) && ((millis() - this->msgSendTime_) > FAN_REPLY_TIMEOUT)) {
+      if ((this->retries_ >= 0) && ((millis() - this->msgSendTime_) > this->replyTimeout_)) {
+        ZEHNDER_TRACE(nrf905::TraceReplyTimeout, this->retries_);
         ESP_LOGD(TAG, "Timeout waiting for RX reply.");
+        ++this->csmaStats_.unanswered;
+        ++this->linkStats_.timeouts;
+        if (this->linkTracked_) {
+          this->linkLoss(true);
+        }
+        this->retransmitted_ = true;
+        this->replyTimeout_ = std::min(this->replyTimeout_ * 2, (uint32_t) FAN_RTO_MAX); // Back off
         if (this->retries_ > 0) {
           this->retries_--;
           ESP_LOGD(TAG, "Retrying transmission (retries left: %d)...", this->retries_);
-          delay(150); // Short delay before retrying
-          this->rfState_ = RfStateWaitAirwayFree; // Go back to check airway
-          this->airwayFreeWaitTime_ = millis();
+          // Likely a collision: back off from a wider window
+          this->csmaWindow_ = std::min((uint16_t) (this->csmaWindow_ * 2), this->csmaMaxWindow_);
+          this->retryTime_ = millis();
+          this->rfState_ = RfStateRetryWait; // Short gap before retrying
         } else { // retries_ == 0
           ESP_LOGW(TAG, "No reply received after all retries. Giving up.");
-          if (this->onReceiveTimeout_ != nullptr) {
-            this->onReceiveTimeout_(); // Trigger the final timeout callback
-          }
-          this->rfState_ = RfStateIdle; // Return RF layer to Idle
-          // If the main state machine was waiting for this reply, reset it too
-           if (this->state_ == StateWaitFanSettings || this->state_ == StateDiscoveryWaitForLinkRequest || 
-              this->state_ == StateDiscoveryWaitForJoinResponse || this->state_ == StateDiscoveryJoinComplete) {
-              ESP_LOGW(TAG, "Timeout waiting for response in state %d, returning to StateIdle.", this->state_);
-              this->state_ = StateIdle;
-          }
+          this->rfFail();
         }
       }
       break;
+
+    case RfStateRetryWait:
+      if ((millis() - this->retryTime_) >= FAN_RETRY_GAP) {
+        if ((this->txPriority_ == TxPriorityPoll) && !this->dutyAllows(TxPriorityPoll)) {
+          ESP_LOGD(TAG, "Airtime budget low, dropping poll retries.");
+          ++this->dutyStats_.droppedRetries;
+          this->rfFail();
+        } else {
+          this->rfAccess(); // Go back to check airway
+        }
+      }
+      break;
+
+    case RfStateWaitBudget:
+      if (this->dutyAllows(this->txPriority_)) {
+        const uint32_t delay = millis() - this->dutyWaitTime_;
+
+        ESP_LOGD(TAG, "Airtime budget refilled after %u ms.", delay);
+        this->dutyStats_.maxCommandDelay = std::max(this->dutyStats_.maxCommandDelay, delay);
+        this->airwayFreeWaitTime_ = millis();
+        this->csmaStart();
+      }
+      break;
+  }
+}
+
+void ZehnderRF::rfFail(void) {
+  if (this->retries_ >= 0) {
+    this->linkFinished(false); // Only exchanges that expected a reply were counted as a transaction
+  }
+  this->csmaWindow_ = this->csmaMinWindow_;
+  if (this->onReceiveTimeout_ != nullptr) {
+    this->onReceiveTimeout_(); // Trigger the final timeout callback
+  }
+  this->rfState_ = RfStateIdle; // Return RF layer to Idle
+  // If the main state machine was waiting for this reply, reset it too
+  if (this->state_ == StateWaitFanSettings || this->state_ == StateDiscoveryWaitForLinkRequest ||
+      this->state_ == StateDiscoveryWaitForJoinResponse || this->state_ == StateDiscoveryJoinComplete) {
+    ESP_LOGW(TAG, "Timeout waiting for response in state %d, returning to StateIdle.", this->state_);
+    this->state_ = StateIdle;
+  }
+}
+
+void ZehnderRF::csmaStart(void) {
+  const bool poweredDown = this->rf_->getMode() == nrf905::PowerDown;
+
+  // Carrier detect only works while receiving
+  this->rf_->wake();
+  if (this->rf_->getMode() != nrf905::Receive) {
+    this->rf_->setMode(nrf905::Receive);
+  }
+
+  this->csmaBackoff_ = (1 + (random_uint32() % this->csmaWindow_)) * this->csmaSlotTime_;
+  if (poweredDown) {
+    this->csmaBackoff_ += NRF905_POWER_UP_TIME; // CD means nothing until the receiver has settled
+  }
+  this->csmaClear_ = true;
+  this->csmaClearSince_ = millis();
+  this->rfState_ = RfStateWaitAirwayFree;
+  this->highFreq_.start();
+}
+
+void ZehnderRF::csmaTransmit(const uint32_t now) {
+  const uint32_t accessDelay = now - this->airwayFreeWaitTime_;
+
+  ++this->csmaStats_.accesses;
+  this->csmaStats_.totalAccessDelay += accessDelay;
+  this->csmaStats_.maxAccessDelay = std::max(this->csmaStats_.maxAccessDelay, accessDelay);
+  this->linkStats_.totalAirwayWait += accessDelay;
+  ++this->linkStats_.airwayWaits;
+  ++this->linkStats_.airwayWait[histogramBucket(accessDelay, 2)];
+  this->highFreq_.stop();
+
+  this->dutyRefill();
+  this->dutyTokens_ -= std::min(this->dutyTokens_, (uint64_t) this->rf_->getTxTime(FAN_TX_FRAMES) * 1000);
+
+  // What comes back answers this request, even when it reads exactly like the answer to the previous one
+  if (this->retries_ >= 0) {
+    for (auto &entry : this->dedupCache_) {
+      entry.valid = false;
+    }
+  }
+
+  // Expect reply? Then set next mode to Receive. No reply? Set next mode to Idle.
+  nrf905::Mode next_mode = (this->retries_ >= 0) ? nrf905::Receive : nrf905::Idle;
+  this->rf_->startTx(FAN_TX_FRAMES, next_mode);
+  this->rfState_ = RfStateTxBusy;
+}
+
+void ZehnderRF::dumpCsmaStats(void) {
+  const CsmaStats *const stats = &this->csmaStats_;
+  const uint32_t outcomes = stats->answered + stats->unanswered;
+  const uint32_t collisionRate = (outcomes > 0) ? ((stats->unanswered * 10000) / outcomes) : 0;
+
+  ESP_LOGI(TAG, "Channel access: %u transmissions, %u deferrals, %u aborts, contention window %u slots",
+           stats->accesses, stats->deferrals, stats->aborts, this->csmaWindow_);
+  ESP_LOGI(TAG, "  Access delay avg %u max %u ms", (stats->accesses > 0) ? (stats->totalAccessDelay / stats->accesses) : 0,
+           stats->maxAccessDelay);
+  ESP_LOGI(TAG, "  %u answered, %u unanswered: collision rate %u.%02u%%", stats->answered, stats->unanswered,
+           collisionRate / 100, collisionRate % 100);
+  ESP_LOGI(TAG, "  Round trip %u ms (deviation %u ms, %u samples), reply timeout %u ms", this->link_.srtt >> 3,
+           this->link_.rttvar >> 2, this->link_.samples, this->replyTimeout());
+  ESP_LOGI(TAG, "  Loss rate %u.%02u%%, %d retries", this->link_.loss / 10000, (this->link_.loss / 100) % 100,
+           this->retryBudget());
+}
+
+void ZehnderRF::resetCsmaStats(void) {
+  memset(&this->csmaStats_, 0, sizeof(this->csmaStats_));
+  this->publishCsmaStats();
+}
+
+void ZehnderRF::publishCsmaStats(void) {
+  const CsmaStats *const stats = &this->csmaStats_;
+  const uint32_t outcomes = stats->answered + stats->unanswered;
+
+  if (this->collision_rate_sensor_ != nullptr) {
+    this->collision_rate_sensor_->publish_state((outcomes > 0) ? (stats->unanswered * 100.0f) / outcomes : NAN);
+  }
+  if (this->access_delay_sensor_ != nullptr) {
+    this->access_delay_sensor_->publish_state(
+        (stats->accesses > 0) ? (float) stats->totalAccessDelay / stats->accesses : NAN);
+  }
+}
+
+void ZehnderRF::linkAnswered(void) {
+  if (!this->linkTracked_) {
+    return;
+  }
+  this->linkLoss(false);
+
+  // Only an answer to the first transmission tells the round trip; after a retry it could be either's (Karn)
+  if (this->retransmitted_ || (this->rfState_ != RfStateRxWait)) {
+    return;
+  }
+  const uint32_t rtt = this->rxTime_ - this->msgSendTime_;
+
+  // RFC 6298, in Jacobson's fixed point: srtt is ms << 3, rttvar ms << 2
+  if (this->link_.samples == 0) {
+    this->link_.srtt = rtt << 3;
+    this->link_.rttvar = rtt << 1;
+  } else {
+    int32_t error = (int32_t) rtt - (int32_t) (this->link_.srtt >> 3);
+    this->link_.srtt += error;
+    if (error < 0) {
+      error = -error;
+    }
+    this->link_.rttvar += error - (int32_t) (this->link_.rttvar >> 2);
+  }
+  ++this->link_.samples;
+  this->linkDirty_ = true;
+  ESP_LOGV(TAG, "Round trip %u ms, smoothed %u ms, reply timeout %u ms", rtt, this->link_.srtt >> 3,
+           this->replyTimeout());
+}
+
+void ZehnderRF::linkLoss(const bool lost) {
+  const int32_t sample = lost ? 1000000 : 0;
+
+  if ((this->link_.networkId != this->config_.fan_networkId) ||
+      (this->link_.mainUnitId != this->config_.fan_main_unit_id)) {
+    this->linkReset(); // Paired with another unit since the estimate started
+  }
+  this->link_.loss += (sample - (int32_t) this->link_.loss) / 8;
+  this->linkDirty_ = true;
+}
+
+void ZehnderRF::linkReset(void) {
+  memset(&this->link_, 0, sizeof(LinkEstimate));
+  this->link_.networkId = this->config_.fan_networkId;
+  this->link_.mainUnitId = this->config_.fan_main_unit_id;
+  this->link_.loss = FAN_LOSS_INITIAL;
+  this->linkDirty_ = false;
+}
+
+void ZehnderRF::linkSave(void) {
+  if (this->linkDirty_ && this->linkPref_.save(&this->link_)) {
+    this->linkDirty_ = false;
+  }
+}
+
+uint32_t ZehnderRF::replyTimeout(void) {
+  if (this->link_.samples == 0) {
+    return FAN_RTO_MAX;
+  }
+  const uint32_t rto = (this->link_.srtt >> 3) + std::max(this->link_.rttvar, (uint32_t) FAN_RTO_GRANULARITY);
+  return std::min(std::max(rto, (uint32_t) FAN_RTO_MIN), (uint32_t) FAN_RTO_MAX);
+}
+
+int8_t ZehnderRF::retryBudget(void) {
+  const float loss = this->link_.loss / 1000000.0f;
+
+  if (loss <= FAN_RETRY_TARGET) {
+    return FAN_RETRIES_MIN;
+  }
+  if (loss >= 0.99f) {
+    return FAN_TX_RETRIES;
+  }
+  // All of 1 + n attempts lost with probability loss^(1 + n)
+  const int32_t retries = (int32_t) ceilf(logf(FAN_RETRY_TARGET) / logf(loss)) - 1;
+  return (int8_t) std::min(std::max(retries, (int32_t) FAN_RETRIES_MIN), (int32_t) FAN_TX_RETRIES);
+}
+
+void ZehnderRF::linkFinished(const bool answered) {
+  const uint8_t retries = (uint8_t) std::max(this->txRetries_ - this->retries_, 0);
+
+  if (!answered) {
+    ++this->linkStats_.failed;
+  } else if (retries == 0) {
+    ++this->linkStats_.firstTry;
+  } else {
+    ++this->linkStats_.retried;
+  }
+  this->linkStats_.totalRetries += retries;
+  ++this->linkStats_.retries[std::min(retries, (uint8_t) (FAN_HISTOGRAM_BUCKETS - 1))];
+}
+
+void ZehnderRF::publishLinkStats(void) {
+  const LinkStats *const stats = &this->linkStats_;
+  const uint32_t answered = stats->firstTry + stats->retried;
+  const uint32_t finished = answered + stats->failed;
+  float values[LinkSensorCount];
+
+  values[LinkSensorTransactions] = stats->transactions;
+  values[LinkSensorFirstTryRate] = (finished > 0) ? (stats->firstTry * 100.0f) / finished : NAN;
+  values[LinkSensorFailed] = stats->failed;
+  values[LinkSensorTimeouts] = stats->timeouts;
+  values[LinkSensorReplyLatency] = (answered > 0) ? (float) stats->totalLatency / answered : NAN;
+  values[LinkSensorRetries] = (finished > 0) ? (float) stats->totalRetries / finished : NAN;
+  values[LinkSensorAirwayWait] = (stats->airwayWaits > 0) ? (float) stats->totalAirwayWait / stats->airwayWaits : NAN;
+  values[LinkSensorUnexpected] = stats->unexpected;
+  values[LinkSensorDuplicates] = stats->duplicates;
+  values[LinkSensorUnknownSource] = stats->unknownSource;
+
+  for (uint8_t i = 0; i < LinkSensorCount; ++i) {
+    if (this->link_sensors_[i] != nullptr) {
+      this->link_sensors_[i]->publish_state(values[i]);
+    }
   }
 }
 
+static void logHistogram(const char *const name, const uint32_t *const histogram) {
+  ESP_LOGI(TAG, "  %-12s %6u %6u %6u %6u %6u %6u %6u %6u", name, histogram[0], histogram[1], histogram[2],
+           histogram[3], histogram[4], histogram[5], histogram[6], histogram[7]);
+}
+
+void ZehnderRF::dumpLinkStats(void) {
+  const LinkStats *const stats = &this->linkStats_;
+
+  ESP_LOGI(TAG, "Link: %u transactions, %u first try, %u retried, %u failed, %u timeouts", stats->transactions,
+           stats->firstTry, stats->retried, stats->failed, stats->timeouts);
+  ESP_LOGI(TAG, "  Frames: %u unexpected, %u duplicates, %u from unknown sources", stats->unexpected,
+           stats->duplicates, stats->unknownSource);
+  ESP_LOGI(TAG, "  %-12s %6s %6s %6s %6s %6s %6s %6s %6s", "Latency ms", "<25", "<50", "<100", "<200", "<400", "<800",
+           "<1600", "more");
+  logHistogram("", stats->replyLatency);
+  ESP_LOGI(TAG, "  %-12s %6s %6s %6s %6s %6s %6s %6s %6s", "Retries", "0", "1", "2", "3", "4", "5", "6", "more");
+  logHistogram("", stats->retries);
+  ESP_LOGI(TAG, "  %-12s %6s %6s %6s %6s %6s %6s %6s %6s", "Airway ms", "<2", "<4", "<8", "<16", "<32", "<64", "<128",
+           "more");
+  logHistogram("", stats->airwayWait);
+}
+
+void ZehnderRF::resetLinkStats(void) {
+  memset(&this->linkStats_, 0, sizeof(this->linkStats_));
+  this->publishLinkStats();
+}
+
+void ZehnderRF::dutyRefill(void) {
+  const uint32_t now = millis();
+  const uint64_t capacity = (uint64_t) this->dutyBurst_ * 1000000;
+
+  this->dutyTokens_ = std::min(capacity, this->dutyTokens_ + ((uint64_t) (now - this->dutyUpdated_) * this->dutyRate_));
+  this->dutyUpdated_ = now;
+}
+
+bool ZehnderRF::dutyAllows(const TxPriority priority) {
+  uint64_t needed = (uint64_t) this->rf_->getTxTime(FAN_TX_FRAMES) * 1000;
+
+  if (priority == TxPriorityPoll) {
+    needed += ((uint64_t) this->dutyBurst_ * 1000000 * this->dutyPollReserve_) / 100;
+  }
+  this->dutyRefill();
+  return this->dutyTokens_ >= needed;
+}
+
+uint32_t ZehnderRF::getAirtimeBudget(void) {
+  this->dutyRefill();
+  return (uint32_t) (this->dutyTokens_ / 1000);
+}
+
+void ZehnderRF::publishDutyCycle(void) {
+  if (this->airtime_budget_sensor_ != nullptr) {
+    this->airtime_budget_sensor_->publish_state(this->getAirtimeBudget() / 1000.0f);
+  }
+  if (this->deferred_polls_sensor_ != nullptr) {
+    this->deferred_polls_sensor_->publish_state(this->dutyStats_.deferredPolls + this->dutyStats_.droppedRetries);
+  }
+  if (this->deferred_commands_sensor_ != nullptr) {
+    this->deferred_commands_sensor_->publish_state(this->dutyStats_.deferredCommands);
+  }
+}
+
+void ZehnderRF::dumpDutyCycle(void) {
+  const DutyCycleStats *const stats = &this->dutyStats_;
+  const uint32_t budget = this->getAirtimeBudget();
+
+  ESP_LOGI(TAG, "Duty cycle: %u.%03u of %u ms airtime budget left, refill %u ppm", budget / 1000, budget % 1000,
+           this->dutyBurst_, this->dutyRate_);
+  ESP_LOGI(TAG, "  %u polls deferred, %u poll retries dropped, %u commands held (max %u ms)", stats->deferredPolls,
+           stats->droppedRetries, stats->deferredCommands, stats->maxCommandDelay);
+}
+
 } // namespace zehnder
 } // namespace esphome
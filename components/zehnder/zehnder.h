@@ -4,7 +4,7 @@
 #include "esphome/core/component.h"
 #include "esphome/core/preferences.h"
 #include "esphome/core/hal.h"
-#include "esphome/components/spi/spi.h"
+#include "esphome/core/helpers.h"
 #include "esphome/components/fan/fan_state.h"
 #include "esphome/components/nrf905/nRF905.h"
 #include "esphome/components/sensor/sensor.h"
@@ -23,6 +23,44 @@ namespace zehnder {
 #define FAN_TX_RETRIES 10       // Retry transmission 10 times if no reply is received
 #define FAN_TTL 250             // 0xFA, default time-to-live for a frame
 #define FAN_REPLY_TIMEOUT 2000  // Wait 2000ms for receiving a reply
+#define FAN_RETRY_GAP 150       // Wait 150ms before retrying a transmission
+
+#define FAN_RTO_MIN 150               // ms, floor of the reply timeout derived from measured round trips
+#define FAN_RTO_MAX FAN_REPLY_TIMEOUT // ms, its ceiling, and the timeout until a round trip has been measured
+#define FAN_RTO_GRANULARITY 20        // ms, loop and scheduling jitter on top of the measured variance
+#define FAN_RETRIES_MIN 2             // Retries never adapt below this
+#define FAN_RETRY_TARGET 0.01f        // Retry until all attempts getting lost is less likely than 1%
+#define FAN_LOSS_INITIAL 500000       // ppm, assumed loss rate of a new link
+#define FAN_LINK_SAVE_INTERVAL 3600000 // ms, how often the link estimate is written to flash
+
+#define FAN_HISTOGRAM_BUCKETS 8       // Last bucket takes everything above the others
+#define FAN_DEDUP_WINDOW 50           // ms, the same frame again within this is a retransmitted copy
+#define FAN_DEDUP_CACHE_SIZE 4        // Recent frames remembered, for copies interleaved with other traffic
+#define FAN_STATS_PUBLISH_INTERVAL 60000
+#define FAN_OBSERVE_TIMEOUT 1000       // Poll if another remote's command isn't acknowledged within 1000ms
+#define FAN_VOLTAGE_SETTLE 500         // ms a percentage slider has to rest before its value is sent
+#define FAN_PERCENTAGE_STEPS 100       // Fan speed steps in percentage control, one per percent
+#define FAN_PERCENTAGE_DEFAULT 50      // Percentage to turn on at without a speed, until one has been seen
+#define FAN_WAKE_AHEAD 20       // Wake the radio 20ms before a poll: its power up time plus a loop pass or two
+
+#define FAN_CSMA_SLOT_TIME 1      // ms, one backoff slot
+#define FAN_CSMA_MIN_WINDOW 8     // Slots, contention window after a success
+#define FAN_CSMA_MAX_WINDOW 128   // Slots, the window stops doubling here
+#define FAN_CSMA_TIMEOUT 5000     // ms, give up on channel access after this
+
+#define FAN_DUTY_WINDOW 3600000       // ms, ETSI EN 300 220 observation period
+#define FAN_DUTY_LIMIT 10000          // ppm of the window on air: 1% in the 868.0-868.6 MHz sub-band
+#define FAN_DUTY_BURST 1000           // ms of airtime the token bucket holds
+#define FAN_DUTY_POLL_RESERVE 50      // % of the bucket polls leave untouched for commands
+#define FAN_DUTY_PUBLISH_INTERVAL 60000
+
+#define FAN_COMMAND_QUEUE_SIZE 2  // Commands of a kind coalesce: one fan target and one query, poll or diagnostic
+
+#ifdef USE_ZEHNDER_TRACE
+#define ZEHNDER_TRACE(...) ::esphome::nrf905::global_trace.record(__VA_ARGS__)
+#else
+#define ZEHNDER_TRACE(...)
+#endif
 
 /* Fan device types */
 enum {
@@ -68,10 +106,121 @@ enum {
 #define NETWORK_DEFAULT_ID 0xE7E7E7E7
 #define FAN_JOIN_DEFAULT_TIMEOUT 10000
 
-typedef enum { ResultOk, ResultBusy, ResultFailure } Result;
+typedef enum { ResultOk, ResultBusy, ResultFailure, ResultDeferred } Result;
+
+/* What to do when the channel stays busy past the access timeout */
+typedef enum { CsmaAbortDrop, CsmaAbortTransmit } CsmaAbort;
+
+typedef struct {
+  uint32_t accesses;          // Transmissions put on air
+  uint32_t deferrals;         // Backoffs frozen by a busy channel
+  uint32_t aborts;            // Channel access timeouts
+  uint32_t answered;          // Transmissions that got their reply
+  uint32_t unanswered;        // Transmissions that timed out: collided or lost
+  uint32_t totalAccessDelay;  // ms, from wanting to send until on air
+  uint32_t maxAccessDelay;    // ms
+} CsmaStats;
+
+/* Airtime budget classes: polls give way to commands when the duty cycle budget runs low */
+typedef enum { TxPriorityPoll, TxPriorityCommand } TxPriority;
+
+typedef struct {
+  uint32_t deferredPolls;     // Polls skipped until the next interval
+  uint32_t droppedRetries;    // Poll retries given up
+  uint32_t deferredCommands;  // Commands held until the bucket refilled
+  uint32_t maxCommandDelay;   // ms
+} DutyCycleStats;
+
+/* Command queue priorities, lowest first: user commands go before polls, polls before diagnostics */
+typedef enum { CommandPriorityDiagnostic, CommandPriorityPoll, CommandPriorityUser } CommandPriority;
+
+typedef enum { CommandSetSpeed, CommandSetVoltage, CommandQuery } CommandType;
+
+/* What the fan speed controls: the presets (0x02/0x03), or the output voltage in percent (0x01) */
+typedef enum { SpeedControlPresets, SpeedControlPercentage } SpeedControl;
+
+/* How a queued command ended */
+typedef enum {
+  CommandDone,        // Sent, and confirmed as far as the protocol allows
+  CommandFailed,      // Not paired, no channel, no budget or no reply
+  CommandSuperseded,  // A newer command of the same kind replaced it before it was sent
+} CommandResult;
+
+typedef std::function<void(const CommandResult result)> CommandCallback;
+
+typedef struct {
+  CommandType type;
+  CommandPriority priority;
+  uint8_t speed;
+  uint8_t timer;
+  uint8_t voltage;  // %, CommandSetVoltage
+  uint32_t queued;  // Time it entered the queue
+  CommandCallback callback;
+} Command;
+
+/* Round trip and loss estimate of the link to the main unit, kept in flash across reboots */
+typedef struct {
+  uint32_t networkId;  // Peer the estimate belongs to
+  uint8_t mainUnitId;
+  uint32_t srtt;       // ms << 3, smoothed round trip from TX ready to reply
+  uint32_t rttvar;     // ms << 2, smoothed mean deviation
+  uint32_t samples;    // Round trips measured
+  uint32_t loss;       // ppm, moving average of unanswered transmissions
+} LinkEstimate;
+
+/* Protocol statistics, for spotting a failing link before users do.
+ * Histogram buckets double from the first edge: latency <25, <50, ... <1600, >=1600 ms; airway wait <2, <4, ...
+ * <128, >=128 ms; retries 0, 1, ... 6, >=7. */
+typedef struct {
+  uint32_t transactions;     // Transmissions that expected a reply
+  uint32_t firstTry;         // Answered without retrying
+  uint32_t retried;          // Answered after retrying
+  uint32_t failed;           // No reply after all retries
+  uint32_t timeouts;         // Reply timeouts, each retry's included
+  uint32_t unexpected;       // Frames the state machine wasn't waiting for
+  uint32_t duplicates;       // Retransmitted copies dropped before dispatch
+  uint32_t unknownSource;    // Frames from neither the main unit nor a remote talking to it
+  uint32_t totalLatency;     // ms, TX ready until the reply of answered transactions
+  uint32_t totalRetries;     // Of answered and failed transactions
+  uint32_t totalAirwayWait;  // ms
+  uint32_t airwayWaits;
+  uint32_t replyLatency[FAN_HISTOGRAM_BUCKETS];
+  uint32_t retries[FAN_HISTOGRAM_BUCKETS];
+  uint32_t airwayWait[FAN_HISTOGRAM_BUCKETS];
+} LinkStats;
+
+/* Sensors for LinkStats, see set_link_sensor() */
+typedef enum {
+  LinkSensorTransactions,
+  LinkSensorFirstTryRate,  // %
+  LinkSensorFailed,
+  LinkSensorTimeouts,
+  LinkSensorReplyLatency,  // ms, average
+  LinkSensorRetries,       // Average per transaction
+  LinkSensorAirwayWait,    // ms, average
+  LinkSensorUnexpected,
+  LinkSensorDuplicates,
+  LinkSensorUnknownSource,
+  LinkSensorCount
+} LinkSensor;
+
+/* Fan state as last known. Replaced as a whole on every sample, never changed in place, so the published sensors
+ * always describe one consistent moment. */
+typedef struct {
+  uint8_t speed;     // FAN_SPEED_*
+  uint8_t voltage;   // %, only from the unit's own settings frames
+  uint8_t timer;     // Minutes left, 0 = none
+  bool hasVoltage;   // Voltage has been reported at all
+  bool fromUnit;     // Reported by the unit, not taken from a command
+  uint32_t updated;  // millis() of the sample
+} FanSnapshot;
 
 // --- Struct Definitions --- (Define BEFORE use in RfFrame)
 
+typedef struct __attribute__((packed)) {
+  uint8_t voltage;
+} RfPayloadFanSetVoltage;
+
 typedef struct __attribute__((packed)) {
   uint8_t speed;
 } RfPayloadFanSetSpeed;
@@ -110,6 +259,7 @@ typedef struct __attribute__((packed)) {
   uint8_t parameter_count;
   union {
     uint8_t parameters[9]; // Max payload size is 9 (16 Frame - 7 Header)
+    RfPayloadFanSetVoltage setVoltage;
     RfPayloadFanSetSpeed setSpeed;
     RfPayloadFanSetTimer setTimer;
     RfPayloadNetworkJoinRequest networkJoinRequest;
@@ -131,35 +281,96 @@ class ZehnderRF : public Component, public fan::Fan {
   void dump_config() override;
   void loop() override;
   float get_setup_priority() const override { return setup_priority::DATA; }
+  void on_shutdown() override;
 
   // Setup methods
   void set_rf(nrf905::nRF905 *const pRf) { rf_ = pRf; }
-  void set_update_interval(const uint32_t interval) { interval_ = interval; }
+  void set_update_interval(const uint32_t interval) { interval_ = interval; pollInterval_ = interval; }
+  void set_max_update_interval(const uint32_t interval) { maxInterval_ = interval; }
+  void set_confirm_commands(const bool confirm) { confirmCommands_ = confirm; }
+  void set_passive_tracking(const bool tracking) { passiveTracking_ = tracking; }
+  void set_dedup_window(const uint32_t window) { dedupWindow_ = window; }
+  void set_csma_slot_time(const uint32_t slotTime) { csmaSlotTime_ = slotTime; }
+  void set_csma_min_window(const uint16_t window) { csmaMinWindow_ = window; csmaWindow_ = window; }
+  void set_csma_max_window(const uint16_t window) { csmaMaxWindow_ = window; }
+  void set_csma_timeout(const uint32_t timeout) { csmaTimeout_ = timeout; }
+  void set_csma_abort(const CsmaAbort abort) { csmaAbort_ = abort; }
+  void set_duty_cycle_limit(const uint32_t limit) { dutyLimit_ = limit; }
+  void set_duty_cycle_burst(const uint32_t burst) { dutyBurst_ = burst; }
+  void set_duty_cycle_poll_reserve(const uint8_t reserve) { dutyPollReserve_ = reserve; }
+  void set_voltage_deadband(const uint8_t deadband) { voltageDeadband_ = deadband; }
+  void set_speed_control(const SpeedControl control) { speedControl_ = control; }
+  void set_voltage_settle(const uint32_t settle) { voltageSettle_ = settle; }
+  void set_heartbeat_interval(const uint32_t interval) { heartbeatInterval_ = interval; }
 
   // Sensor setters
   void set_ventilation_percentage_sensor(sensor::Sensor *sensor) { ventilation_percentage_sensor_ = sensor; }
   void set_timer_binary_sensor(binary_sensor::BinarySensor *sensor) { timer_binary_sensor_ = sensor; }
+  void set_state_confirmed_binary_sensor(binary_sensor::BinarySensor *sensor) { state_confirmed_binary_sensor_ = sensor; }
   void set_ventilation_mode_text_sensor(text_sensor::TextSensor *sensor) { ventilation_mode_text_sensor_ = sensor; }
   // Keep diagnostic sensor setters even if query logic is removed
   void set_filter_remaining_sensor(sensor::Sensor *sensor) { filter_remaining_sensor_ = sensor; }
   void set_filter_runtime_sensor(sensor::Sensor *sensor) { filter_runtime_sensor_ = sensor; }
   void set_error_count_sensor(sensor::Sensor *sensor) { error_count_sensor_ = sensor; }
   void set_error_code_sensor(text_sensor::TextSensor *sensor) { error_code_sensor_ = sensor; }
+  void set_confirmation_latency_sensor(sensor::Sensor *sensor) { confirmation_latency_sensor_ = sensor; }
+  void set_link_sensor(const LinkSensor which, sensor::Sensor *sensor) { link_sensors_[which] = sensor; }
+  void set_collision_rate_sensor(sensor::Sensor *sensor) { collision_rate_sensor_ = sensor; }
+  void set_access_delay_sensor(sensor::Sensor *sensor) { access_delay_sensor_ = sensor; }
+  void set_airtime_budget_sensor(sensor::Sensor *sensor) { airtime_budget_sensor_ = sensor; }
+  void set_deferred_polls_sensor(sensor::Sensor *sensor) { deferred_polls_sensor_ = sensor; }
+  void set_deferred_commands_sensor(sensor::Sensor *sensor) { deferred_commands_sensor_ = sensor; }
+  void set_startup_time_sensor(sensor::Sensor *sensor) { startup_time_sensor_ = sensor; }
 
   // Fan interface implementation
   fan::FanTraits get_traits() override;
-  int get_speed_count() { return this->speed_count_; }
+  int get_speed_count() {
+    return (this->speedControl_ == SpeedControlPercentage) ? FAN_PERCENTAGE_STEPS : this->speed_count_;
+  }
   void control(const fan::FanCall &call) override;
 
   // Public methods/members for YAML access
-  void setSpeed(const uint8_t speed, const uint8_t timer = 0);
+  // Queue a speed change (with timer in minutes, 0 = none); a newer one replaces it until it is sent
+  void setSpeed(const uint8_t speed, const uint8_t timer = 0, const CommandCallback callback = nullptr);
+  // Queue an output voltage in percent; replaces a queued speed change as well
+  void setVoltage(const uint8_t voltage, const CommandCallback callback = nullptr);
+  // Queue a status query that samples the link for the link statistics; goes after user commands and polls, and
+  // rides along with a poll already queued
+  void probeLink(const CommandCallback callback = nullptr);
   bool timer = false;
   int voltage = 0;
+  // False while the fan state comes from a command nobody acknowledged yet
+  bool isStateConfirmed(void) { return this->stateConfirmed_; }
+  const FanSnapshot &getSnapshot(void) { return this->snapshot_; }
+  uint32_t getStartupTime(void) { return this->startupTime_; } // ms from boot to the first fan status, 0 = none yet
+
+  // Channel access metrics
+  const CsmaStats &getCsmaStats(void) { return this->csmaStats_; }
+  void dumpCsmaStats(void);
+  void resetCsmaStats(void);
+
+  // Link to the main unit
+  const LinkEstimate &getLinkEstimate(void) { return this->link_; }
+  uint32_t replyTimeout(void); // ms, smoothed round trip plus four deviations, within the floor and ceiling
+  int8_t retryBudget(void); // Retries needed to get through at the recent loss rate
+  const LinkStats &getLinkStats(void) { return this->linkStats_; }
+  void dumpLinkStats(void);
+  void resetLinkStats(void);
+
+  // Duty cycle governor
+  uint32_t getAirtimeBudget(void); // us of airtime left in the bucket
+  const DutyCycleStats &getDutyCycleStats(void) { return this->dutyStats_; }
+  void dumpDutyCycle(void);
 
  protected:
   // Core logic methods
-  void queryDevice(void);
+  Result sendSpeed(const uint8_t speed, const uint8_t timer);
+  Result sendVoltage(const uint8_t voltage);
+  Result sendFanCommand(RfFrame *const frame); // Speed or voltage, to the main unit
+  Result queryDevice(void);
+  void logQueryCost(const bool answered); // Radio activity since queryDevice(), retries included
   uint8_t createDeviceID(void);
+  bool pairingValid(void); // The stored pairing record describes a network we joined
   std::string speedToMode_(uint8_t speed_preset);
 
   // Discovery logic methods
@@ -168,15 +379,46 @@ class ZehnderRF : public Component, public fan::Fan {
   void handleDiscoveryJoinResponse(const RfFrame *const frame);
   void handleDiscoveryJoinComplete(const RfFrame *const frame);
 
+  // Command queue
+  void queueCommand(Command command); // Coalesces with a queued command of the same kind
+  void dispatchCommand(void); // Send the most important queued command, RF layer must be idle
+  void completeCommand(const CommandResult result); // The dispatched command ended
+
   // Settings handler method
   void handleFanSettings(const RfFrame *const frame);
+  void pollSample(const RfPayloadFanSettings *const settings); // Adapt the poll interval to a fresh sample
+  bool fromMainUnit(const RfFrame *const frame);
+  void handleSetSpeedReply(const RfFrame *const frame); // 0x05 or 0x07 acknowledging a confirmed speed change
+  bool observeFrame(const RfFrame *const frame); // Other remotes' traffic with the unit, true if it was that
+  void publishSpeed(const uint8_t speed, const uint8_t timer); // Fan state known from a command, not a 0x07
+  void publishVoltage(const uint8_t voltage); // Voltage known from a command, not a 0x07
+  void publishSnapshot(const FanSnapshot &next); // Replace the snapshot, publish what changed
+  void setStateConfirmed(const bool confirmed); // Whether the published state is the unit's own word
 
   // RF Layer interaction methods
   Result startTransmit(const uint8_t *const pData, const int8_t rxRetries = -1,
-                       const std::function<void(void)> timeoutCallback = nullptr);
+                       const std::function<void(void)> timeoutCallback = nullptr,
+                       const TxPriority priority = TxPriorityCommand,
+                       const uint32_t replyTimeout = FAN_REPLY_TIMEOUT);
   void rfComplete(void); // Called when TX/RX cycle finishes (success or timeout)
   void rfHandler(void); // Handles timeouts, retries, airway check
-  void rfHandleReceived(const uint8_t *const pData, const uint8_t dataLength); // Called by nRF905 callback
+  void rfAccess(void); // Wait for airtime budget if needed, then contend for the channel
+  void rfFail(void); // No reply after all retries: give up on the transmission
+  void csmaStart(void); // Draw a backoff and start sensing the channel
+  void csmaTransmit(const uint32_t now); // Channel won, put the payload on air
+  void dutyRefill(void); // Credit the bucket with the airtime earned since the last call
+  bool dutyAllows(const TxPriority priority); // Enough budget to put one transmission on air at this priority
+  void publishDutyCycle(void);
+  void linkAnswered(void); // The reply to a tracked transmission arrived
+  void linkLoss(const bool lost);
+  void linkReset(void); // Start over for the current peer
+  void linkSave(void);
+  void linkFinished(const bool answered); // Transaction over: count its retries
+  void publishLinkStats(void);
+  void publishCsmaStats(void);
+  void rfDispatchReceived(void); // Drains the nRF905 RX queue
+  bool rfIsDuplicate(const RfFrame *const frame, const uint32_t time);
+  void rfHandleReceived(const uint8_t *const pData, const uint8_t dataLength); // Called per queued frame
 
   // --- State Machines ---
   typedef enum {
@@ -188,15 +430,21 @@ class ZehnderRF : public Component, public fan::Fan {
     StateIdle,
     StateWaitFanSettings, // State for waiting for reply to queryDevice (0x10)
     StateWaitSetSpeedConfirm, // State for waiting for TX confirmation of setSpeed/setTimer
+    StateWaitSetSpeedReply, // State for waiting for the unit to acknowledge setSpeed/setTimer
     // Removed diagnostic query states
   } State;
   State state_{StateStartup};
+#ifdef USE_ZEHNDER_TRACE
+  State tracedState_{StateStartup};
+#endif
 
   typedef enum {
     RfStateIdle,
     RfStateWaitAirwayFree,
     RfStateTxBusy, // Waiting for TX complete interrupt from nRF905
     RfStateRxWait, // Waiting for RX complete interrupt or timeout
+    RfStateRetryWait, // Short gap before retrying an unanswered transmission
+    RfStateWaitBudget, // Duty cycle budget exhausted, waiting for the bucket to refill
   } RfState;
   RfState rfState_{RfStateIdle};
 
@@ -213,29 +461,111 @@ class ZehnderRF : public Component, public fan::Fan {
 
   // --- Member Variables ---
   nrf905::nRF905 *rf_ = nullptr;
-  uint32_t interval_ = 15000; // Default update interval (ms)
+  uint32_t interval_ = 15000; // Default update interval (ms), the fastest the poll interval gets
+  uint32_t maxInterval_ = 300000; // The poll interval doubles up to this while nothing changes (ms)
+  bool confirmCommands_{true}; // Wait for the unit to acknowledge speed changes, publish only then
+  bool passiveTracking_{true}; // Follow other remotes' speed changes between polls
   int speed_count_ = 4; // Default speed count (Auto=0, Low=1, Med=2, High=3, Max=4 -> use 4 speeds for HA)
+  SpeedControl speedControl_{SpeedControlPresets};
+  uint32_t voltageSettle_{FAN_VOLTAGE_SETTLE};
+  uint8_t settleVoltage_{0}; // Latest slider value, sent once it rests
+  uint8_t lastVoltage_{FAN_PERCENTAGE_DEFAULT}; // Last non-zero percentage, what turning on without a speed uses
 
   // Sensor pointers
   sensor::Sensor *ventilation_percentage_sensor_{nullptr};
   binary_sensor::BinarySensor *timer_binary_sensor_{nullptr};
+  binary_sensor::BinarySensor *state_confirmed_binary_sensor_{nullptr};
   text_sensor::TextSensor *ventilation_mode_text_sensor_{nullptr};
   sensor::Sensor *filter_remaining_sensor_{nullptr};
   sensor::Sensor *filter_runtime_sensor_{nullptr};
   sensor::Sensor *error_count_sensor_{nullptr};
   text_sensor::TextSensor *error_code_sensor_{nullptr};
+  sensor::Sensor *confirmation_latency_sensor_{nullptr};
+  sensor::Sensor *startup_time_sensor_{nullptr};
+  sensor::Sensor *link_sensors_[LinkSensorCount]{};
+  sensor::Sensor *collision_rate_sensor_{nullptr};
+  sensor::Sensor *access_delay_sensor_{nullptr};
+  sensor::Sensor *airtime_budget_sensor_{nullptr};
+  sensor::Sensor *deferred_polls_sensor_{nullptr};
+  sensor::Sensor *deferred_commands_sensor_{nullptr};
 
   // RF state tracking
-  uint32_t lastFanQuery_{0};
+  uint32_t lastFanQuery_{0}; // Time of the last poll or valid settings frame
+  uint32_t pollInterval_{15000}; // Current poll interval (ms)
+  RfPayloadFanSettings lastSettings_{}; // Last sample, to tell changes by
+  uint32_t lastChange_{0}; // Time the settings last changed
+
+  // Another remote's command seen on air, waiting for the unit's acknowledgement
+  typedef struct {
+    uint8_t type;
+    uint8_t id;
+    uint8_t speed;
+    uint8_t timer;
+  } ObservedCommand;
+  ObservedCommand observed_{};
+  bool observedPending_{false};
+  bool stateConfirmed_{false};
+  FanSnapshot snapshot_{};
+  uint32_t startupTime_{0};
+  bool snapshotPublished_{false};
+  uint32_t lastHeartbeat_{0}; // Time everything was last published
+  int16_t publishedVoltage_{-1}; // Deadband reference, -1 = nothing published
+  uint8_t voltageDeadband_{0}; // Percentage points a voltage change must exceed to publish
+  uint32_t heartbeatInterval_{0}; // Republish unchanged values this often, 0 = only on change
+  bool haveSettings_{false};
   uint32_t msgSendTime_{0}; // Time when the last message expecting a reply was sent
+  uint32_t retryTime_{0}; // Time when the current retry gap started
+  uint32_t replyTimeout_{FAN_REPLY_TIMEOUT}; // For the transmission in progress, doubles on every retry
+  uint32_t rxTime_{0}; // Time the radio took the frame being handled
+  bool linkTracked_{false}; // The transmission in progress is to the paired main unit
+  bool retransmitted_{false}; // Its round trip is ambiguous (Karn)
+  LinkEstimate link_{};
+  ESPPreferenceObject linkPref_;
+  bool linkDirty_{false};
+  int8_t txRetries_{-1}; // Retries the transaction in progress started with
+  LinkStats linkStats_{};
+  struct {
+    RfFrame frame;
+    uint32_t time; // Last copy received
+    bool valid; // Holds a received frame; empty entries match nothing, not even an all-zero frame
+  } dedupCache_[FAN_DEDUP_CACHE_SIZE]{};
+  uint8_t dedupNext_{0}; // Oldest entry, replaced next
+  uint32_t dedupWindow_{FAN_DEDUP_WINDOW}; // 0 disables; the cache is emptied whenever we send a request
+  nrf905::RadioStats queryStart_{}; // Radio stats when the current query started
   uint32_t airwayFreeWaitTime_{0}; // Time when we started waiting for airway clear
   int8_t retries_{-1}; // Retries remaining for the current TX/RX cycle (-1 means no reply expected)
   std::function<void(void)> onReceiveTimeout_ = nullptr; // Callback on timeout
 
-  // Pending command state
-  uint8_t newSpeed{0};
-  uint8_t newTimer{0};
-  bool newSetting{false};
+  // CSMA/CA channel access
+  uint32_t csmaSlotTime_{FAN_CSMA_SLOT_TIME}; // ms
+  uint16_t csmaMinWindow_{FAN_CSMA_MIN_WINDOW}; // Slots
+  uint16_t csmaMaxWindow_{FAN_CSMA_MAX_WINDOW}; // Slots
+  uint32_t csmaTimeout_{FAN_CSMA_TIMEOUT}; // ms
+  CsmaAbort csmaAbort_{CsmaAbortDrop};
+  uint16_t csmaWindow_{FAN_CSMA_MIN_WINDOW}; // Current contention window, doubles on every unanswered transmission
+  uint32_t csmaBackoff_{0}; // ms of clear channel still needed before transmitting
+  uint32_t csmaClearSince_{0}; // Time the channel was last seen going clear
+  bool csmaClear_{false};
+  CsmaStats csmaStats_{};
+  HighFrequencyLoopRequester highFreq_; // Backoff slots are shorter than a regular loop
+
+  // Duty cycle governor: a token bucket of airtime, refilled so that a full bucket plus an observation
+  // period's refill stays within the limit
+  uint32_t dutyLimit_{FAN_DUTY_LIMIT}; // ppm
+  uint32_t dutyBurst_{FAN_DUTY_BURST}; // ms
+  uint8_t dutyPollReserve_{FAN_DUTY_POLL_RESERVE}; // %
+  uint32_t dutyRate_{0}; // ppm, ns of airtime earned per ms
+  uint64_t dutyTokens_{0}; // ns of airtime
+  uint32_t dutyUpdated_{0}; // Time the bucket was last refilled
+  uint32_t dutyWaitTime_{0}; // Time the current command started waiting for budget
+  TxPriority txPriority_{TxPriorityCommand}; // Of the transmission in progress
+  DutyCycleStats dutyStats_{};
+
+  // Command queue, in arrival order; dispatch picks the first of the highest priority
+  Command commandQueue_[FAN_COMMAND_QUEUE_SIZE]{};
+  uint8_t commandCount_{0};
+  Command activeCommand_{}; // Dispatched and not yet completed
+  bool commandActive_{false};
 
   // Fan state cache (used by publish_state - matches FanState members)
   // These are updated by handleFanSettings or control() and read by publish_state()
@@ -0,0 +1,213 @@
+#include <benchmark/benchmark.h>
+
+#include <string.h>
+
+#include "host.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/preferences.h"
+#include "esphome/components/comfofan_emulator/comfofan_emulator.h"
+#include "esphome/components/nrf905/nRF905.h"
+#include "esphome/components/nrf905/nRF905Emulator.h"
+#include "esphome/components/zehnder/zehnder.h"
+
+namespace esphome {
+namespace {
+
+#define BENCH_LOOP_STEP 250  // us of simulated time per main loop pass
+#define BENCH_SETTLE_TIME 100  // ms for the unit to finish sending the copies of its reply
+#define BENCH_REPLY_TIMEOUT 1000  // ms a query may take before it counts as unanswered
+
+class BenchRadio : public nrf905::nRF905 {
+ public:
+  using nRF905::decodeConfigRegisters;
+  using nRF905::encodeConfigRegisters;
+};
+
+class BenchFan : public zehnder::ZehnderRF {
+ public:
+  using ZehnderRF::Config;
+  using ZehnderRF::queryDevice;
+  using ZehnderRF::rfHandleReceived;
+};
+
+/* Bridge and main unit on the simulated air, booted paired and idle. The air medium keeps every node ever
+ * attached, so all benchmarks share one. */
+class Bridge {
+ public:
+  static Bridge &get(void) {
+    static Bridge bridge;
+    return bridge;
+  }
+
+  void step(void) { testing::loopOnce({&this->rf, &this->fan, &this->unit}, BENCH_LOOP_STEP); }
+  void settle(void) {
+    for (uint32_t i = 0; i < (BENCH_SETTLE_TIME * 1000) / BENCH_LOOP_STEP; ++i) {
+      this->step();
+    }
+  }
+
+  nrf905::nRF905Emulator chip;
+  BenchRadio rf;
+  BenchFan fan;
+  comfofan_emulator::ComfoFanEmulator unit;
+
+ protected:
+  Bridge() {
+    // What discovery would have stored on a previous boot
+    BenchFan::Config pairing{0x89ABCDEF, zehnder::FAN_TYPE_REMOTE_CONTROL, 0x7A, zehnder::FAN_TYPE_MAIN_UNIT, 0x42};
+    global_preferences->make_preference<BenchFan::Config>(fnv1_hash("zehnderrf_config"), true).save(&pairing);
+
+    this->rf.set_emulator(&this->chip);
+    this->fan.set_rf(&this->rf);
+    // Only the benchmarks talk to the unit after the first query, and as often as they like
+    this->fan.set_update_interval(86400000);
+    this->fan.set_max_update_interval(86400000);
+    this->fan.set_duty_cycle_limit(1000000);
+
+    this->rf.setup();
+    this->fan.setup();
+    this->unit.setup();
+    while (this->unit.getStats(comfofan_emulator::OperationQuery).confirmed == 0) {
+      this->step();
+    }
+  }
+};
+
+// Bus traffic per operation, from the driver's counters between begin() and end()
+class BusCounters {
+ public:
+  explicit BusCounters(nrf905::nRF905 *const pRf) : rf_(pRf) {}
+
+  void begin(void) { this->start_ = this->rf_->getCounters(); }
+  void end(void) {
+    const nrf905::Counters &now = this->rf_->getCounters();
+
+    this->spiBytes_ += now.spiBytes - this->start_.spiBytes;
+    this->gpioWrites_ += now.gpioWrites - this->start_.gpioWrites;
+  }
+
+  void report(benchmark::State &state) {
+    state.counters["spi_bytes"] = benchmark::Counter(this->spiBytes_, benchmark::Counter::kAvgIterations);
+    state.counters["gpio_writes"] = benchmark::Counter(this->gpioWrites_, benchmark::Counter::kAvgIterations);
+  }
+
+ protected:
+  nrf905::nRF905 *rf_;
+  nrf905::Counters start_{};
+  uint64_t spiBytes_{0};
+  uint64_t gpioWrites_{0};
+};
+
+void BM_EncodeConfig(benchmark::State &state) {
+  Bridge &bridge = Bridge::get();
+  const nrf905::Config config = bridge.rf.getConfig();
+  nrf905::ConfigBuffer buffer;
+  BusCounters counters(&bridge.rf);
+
+  counters.begin();
+  for (auto _ : state) {
+    bridge.rf.encodeConfigRegisters(&config, &buffer);
+    benchmark::DoNotOptimize(buffer);
+  }
+  counters.end();
+  counters.report(state);
+}
+BENCHMARK(BM_EncodeConfig);
+
+void BM_DecodeConfig(benchmark::State &state) {
+  Bridge &bridge = Bridge::get();
+  const nrf905::Config reference = bridge.rf.getConfig();
+  nrf905::ConfigBuffer buffer;
+  nrf905::Config config;
+  BusCounters counters(&bridge.rf);
+
+  bridge.rf.encodeConfigRegisters(&reference, &buffer);
+  counters.begin();
+  for (auto _ : state) {
+    bridge.rf.decodeConfigRegisters(&buffer, &config);
+    benchmark::DoNotOptimize(config);
+  }
+  counters.end();
+  counters.report(state);
+}
+BENCHMARK(BM_DecodeConfig);
+
+// An unsolicited settings frame from the main unit, through the protocol's frame dispatch
+void BM_FrameDispatch(benchmark::State &state) {
+  Bridge &bridge = Bridge::get();
+  zehnder::RfFrame frame;
+  BusCounters counters(&bridge.rf);
+
+  (void) memset(&frame, 0, sizeof(frame));
+  frame.rx_type = zehnder::FAN_TYPE_BROADCAST;
+  frame.tx_type = zehnder::FAN_TYPE_MAIN_UNIT;
+  frame.tx_id = 0x42;
+  frame.ttl = 0xFA;
+  frame.command = zehnder::FAN_TYPE_FAN_SETTINGS;
+  frame.parameter_count = sizeof(zehnder::RfPayloadFanSettings);
+  frame.payload.fanSettings.speed = zehnder::FAN_SPEED_LOW;
+  frame.payload.fanSettings.voltage = 30;
+
+  counters.begin();
+  for (auto _ : state) {
+    bridge.fan.rfHandleReceived((const uint8_t *) &frame, sizeof(frame));
+  }
+  counters.end();
+  counters.report(state);
+}
+BENCHMARK(BM_FrameDispatch);
+
+// queryDevice() until the bridge radio took the reply: TX, the unit's turnaround and RX
+void BM_QueryRoundTrip(benchmark::State &state) {
+  Bridge &bridge = Bridge::get();
+  BusCounters counters(&bridge.rf);
+  const comfofan_emulator::OperationStats &queries = bridge.unit.getStats(comfofan_emulator::OperationQuery);
+  uint64_t simulated = 0;
+  bool answered = true;
+
+  bridge.settle();
+  for (auto _ : state) {
+    const uint32_t confirmed = queries.confirmed;
+    const uint32_t start = millis();
+
+    counters.begin();
+    bridge.fan.queryDevice();
+    while ((queries.confirmed == confirmed) && ((millis() - start) < BENCH_REPLY_TIMEOUT)) {
+      bridge.step();
+      simulated += BENCH_LOOP_STEP;
+    }
+    counters.end();
+    answered = answered && (queries.confirmed != confirmed);
+
+    // A query while the unit still repeats its last reply goes unheard, the unit is half duplex
+    state.PauseTiming();
+    bridge.settle();
+    state.ResumeTiming();
+  }
+  counters.report(state);
+  state.counters["simulated_us"] = benchmark::Counter(simulated, benchmark::Counter::kAvgIterations);
+  if (!answered) {
+    state.SkipWithError("Queries went unanswered");
+  }
+}
+BENCHMARK(BM_QueryRoundTrip);
+
+// One main loop pass of both components with nothing to do
+void BM_IdleLoop(benchmark::State &state) {
+  Bridge &bridge = Bridge::get();
+  BusCounters counters(&bridge.rf);
+
+  counters.begin();
+  for (auto _ : state) {
+    bridge.rf.loop();
+    bridge.fan.loop();
+  }
+  counters.end();
+  counters.report(state);
+}
+BENCHMARK(BM_IdleLoop);
+
+}  // namespace
+}  // namespace esphome
+
+BENCHMARK_MAIN();
@@ -0,0 +1,362 @@
+#include <gtest/gtest.h>
+
+#include <time.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "host.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/preferences.h"
+#include "esphome/components/comfofan_emulator/comfofan_emulator.h"
+#include "esphome/components/nrf905/nRF905.h"
+#include "esphome/components/nrf905/nRF905AirMedium.h"
+#include "esphome/components/nrf905/nRF905Emulator.h"
+#include "esphome/components/zehnder/zehnder.h"
+
+namespace esphome {
+namespace {
+
+#define TEST_LOOP_STEP 250     // us of simulated time per main loop pass
+#define TEST_LOOP_BUDGET 1000  // us a loop() may take at most, in CPU time and in simulated time
+#define TEST_CONTENDERS 2               // Bridges sharing the channel in the contention test
+#define TEST_CONTENTION_INTERVAL 1000   // ms between the polls of each bridge
+#define TEST_CONTENTION_TIME 60000      // ms each channel access scheme runs
+
+class TestFan : public zehnder::ZehnderRF {
+ public:
+  using ZehnderRF::Config;
+  using ZehnderRF::control;
+  using ZehnderRF::queryDevice;
+  using ZehnderRF::rfIsDuplicate;
+};
+
+// A DR/AM line behind a port expander: readable, but no interrupts
+class ExpanderPin : public GPIOPin {
+ public:
+  void setup() override {}
+  void pin_mode(gpio::Flags flags) override {}
+  bool digital_read() override { return false; }
+  void digital_write(bool value) override {}
+  std::string dump_summary() const override { return "expander"; }
+};
+
+static uint64_t threadTime(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+
+  return ((uint64_t) now.tv_sec * 1000000) + (now.tv_nsec / 1000);
+}
+
+/* One loop() call, in whichever is longer: CPU time, or simulated time spent waiting. The simulated clock moves
+ * only when something waits on it, so a blocking delay costs no CPU time here but shows as simulated time. */
+static uint64_t timeLoop(Component *const component) {
+  const uint64_t cpu = threadTime();
+  const uint32_t simulated = esphome::testing::clock().micros();
+
+  component->loop();
+
+  return std::max(threadTime() - cpu, (uint64_t) (esphome::testing::clock().micros() - simulated));
+}
+
+/* A bridge next to an emulated main unit, everything on the simulated clock. Each test runs in its own process,
+ * so the air medium starts out empty. */
+class Bridge : public ::testing::Test {
+ protected:
+  void boot(void) {
+    this->rf_.set_emulator(&this->chip_);
+    this->fan_.set_rf(&this->rf_);
+    this->rf_.setup();
+    this->fan_.setup();
+    this->unit_.setup();
+  }
+
+  // Store the pairing discovery would have left from an earlier boot
+  void pair(void) {
+    TestFan::Config pairing{0x89ABCDEF, zehnder::FAN_TYPE_REMOTE_CONTROL, 0x7A, zehnder::FAN_TYPE_MAIN_UNIT, 0x42};
+
+    global_preferences->make_preference<TestFan::Config>(fnv1_hash("zehnderrf_config"), true).save(&pairing);
+  }
+
+  // Main loop passes until the first fan status or the deadline (ms)
+  void runUntilStatus(const uint32_t deadline) {
+    while ((this->fan_.getStartupTime() == 0) && (millis() < deadline)) {
+      this->step();
+    }
+  }
+
+  // Main loop passes for duration (ms), timing every loop() call of the bridge
+  void run(const uint32_t duration) {
+    const uint32_t end = millis() + duration;
+
+    while (millis() < end) {
+      this->step();
+    }
+  }
+
+  void step(void) {
+    nrf905::global_air_medium.update();
+    this->worstRadioLoop_ = std::max(this->worstRadioLoop_, timeLoop(&this->rf_));
+    this->worstFanLoop_ = std::max(this->worstFanLoop_, timeLoop(&this->fan_));
+    this->unit_.loop();
+    esphome::testing::runScheduler();
+    esphome::testing::clock().advance(TEST_LOOP_STEP);
+  }
+
+  nrf905::nRF905Emulator chip_;
+  nrf905::nRF905 rf_;
+  TestFan fan_;
+  comfofan_emulator::ComfoFanEmulator unit_;
+  uint64_t worstRadioLoop_{0};  // us
+  uint64_t worstFanLoop_{0};    // us
+};
+
+// No radio timing blocks the main loop: discovery, polls with lost replies and retries, a speed change
+TEST_F(Bridge, LoopNeverBlocks) {
+  this->unit_.set_drop_rate(0.5f);
+  this->boot();
+  this->run(60000);
+  this->fan_.control(fan::FanCall().set_state(true).set_speed(zehnder::FAN_SPEED_HIGH));
+  this->run(60000);
+
+  EXPECT_NE(this->unit_.getTimeToPair(), 0u);
+  EXPECT_GT(this->unit_.getStats(comfofan_emulator::OperationQuery).confirmed, 0u);
+  EXPECT_GT(this->unit_.getStats(comfofan_emulator::OperationSetSpeed).started, 0u);
+  EXPECT_LT(this->worstRadioLoop_, (uint64_t) TEST_LOOP_BUDGET);
+  EXPECT_LT(this->worstFanLoop_, (uint64_t) TEST_LOOP_BUDGET);
+}
+
+// Boot with a stored pairing: power up, one query and the reply, no fixed waits in between
+TEST_F(Bridge, PairedBootReportsStatusWithin50ms) {
+  this->pair();
+  this->boot();
+  this->runUntilStatus(10000);
+
+  ASSERT_NE(this->fan_.getStartupTime(), 0u);
+  EXPECT_LT(this->fan_.getStartupTime(), 50u);
+  EXPECT_EQ(this->unit_.getStats(comfofan_emulator::OperationPair).started, 0u);
+}
+
+// DR and AM on expander pins can't interrupt: the status register is polled and the boot goes as without them
+TEST_F(Bridge, ExpanderStatusPinsFallBackToPolling) {
+  ExpanderPin dr;
+  ExpanderPin am;
+
+  this->rf_.set_dr_pin(&dr);
+  this->rf_.set_am_pin(&am);
+  this->pair();
+  this->boot();
+  this->runUntilStatus(10000);
+
+  ASSERT_NE(this->fan_.getStartupTime(), 0u);
+  EXPECT_LT(this->fan_.getStartupTime(), 50u);
+}
+
+// Every copy auto retransmit was asked for reaches the unit, not just the one in flight at the first DR
+TEST_F(Bridge, QuerySendsFanTxFramesCopies) {
+  const comfofan_emulator::OperationStats &queries = this->unit_.getStats(comfofan_emulator::OperationQuery);
+  uint32_t heard;
+  uint64_t airtime;
+
+  this->pair();
+  this->boot();
+  this->runUntilStatus(10000);
+  this->run(1000);
+  heard = queries.requestFrames;
+  airtime = this->rf_.getStats().airtime;
+  this->fan_.queryDevice();
+  this->run(1000);
+
+  EXPECT_EQ(queries.requestFrames - heard, (uint32_t) FAN_TX_FRAMES);
+  // The duty cycle budget is charged for exactly what went on air
+  EXPECT_EQ(this->rf_.getStats().airtime - airtime, (uint64_t) this->rf_.getTxTime(FAN_TX_FRAMES));
+}
+
+// Without passive tracking the radio may sleep between polls: a wall remote's change waits for the next one
+TEST_F(Bridge, PassiveTrackingOffLeavesRemoteChangesToThePoll) {
+  this->rf_.set_power_policy(nrf905::PowerReplyOnly);
+  this->fan_.set_passive_tracking(false);
+  this->pair();
+  this->boot();
+  this->runUntilStatus(10000);
+  this->run(1000);
+
+  this->unit_.remoteSetSpeed(zehnder::FAN_SPEED_MAX);
+  this->run(1000);
+  EXPECT_NE(this->fan_.getSnapshot().speed, zehnder::FAN_SPEED_MAX);
+
+  this->run(60000);
+  EXPECT_EQ(this->fan_.getSnapshot().speed, zehnder::FAN_SPEED_MAX);
+}
+
+// A burst of speed changes: nothing stale goes on air, nothing is lost, every caller hears back
+TEST_F(Bridge, CommandBurstSendsOnlyTheLatestTarget) {
+  const comfofan_emulator::OperationStats &speeds = this->unit_.getStats(comfofan_emulator::OperationSetSpeed);
+  std::vector<zehnder::CommandResult> results(5, zehnder::CommandFailed);
+  std::vector<bool> called(5, false);
+  uint32_t started;
+
+  auto callback = [&results, &called](const size_t i) {
+    return [&results, &called, i](const zehnder::CommandResult result) {
+      results[i] = result;
+      called[i] = true;
+    };
+  };
+
+  this->pair();
+  this->boot();
+  this->runUntilStatus(10000);
+  this->run(1000);
+  started = speeds.started;
+
+  this->fan_.setSpeed(zehnder::FAN_SPEED_LOW, 0, callback(0));
+  this->step();  // In flight now, the rest of the burst queues behind it
+  this->fan_.probeLink(callback(1));
+  this->fan_.setSpeed(zehnder::FAN_SPEED_MEDIUM, 0, callback(2));
+  this->fan_.control(fan::FanCall().set_state(true).set_speed(zehnder::FAN_SPEED_HIGH));
+  this->fan_.setSpeed(zehnder::FAN_SPEED_HIGH, 30, callback(3));
+  this->fan_.setSpeed(zehnder::FAN_SPEED_MAX, 0, callback(4));
+  this->run(5000);
+
+  for (size_t i = 0; i < called.size(); ++i) {
+    EXPECT_TRUE(called[i]) << "callback " << i;
+  }
+  EXPECT_EQ(results[0], zehnder::CommandDone);
+  EXPECT_EQ(results[1], zehnder::CommandDone);
+  EXPECT_EQ(results[2], zehnder::CommandSuperseded);
+  EXPECT_EQ(results[3], zehnder::CommandSuperseded);
+  EXPECT_EQ(results[4], zehnder::CommandDone);
+  EXPECT_EQ(speeds.started - started, 2u);
+  EXPECT_EQ(this->fan_.getSnapshot().speed, zehnder::FAN_SPEED_MAX);
+}
+
+/* Bridges of their own next to one main unit, all paired and polling on the same schedule, so their polls keep
+ * meeting on the air. Each bridge has its own device id, the unit answers whichever asked. */
+class Contention : public ::testing::Test {
+ protected:
+  struct Node {
+    nrf905::nRF905Emulator chip;
+    nrf905::nRF905 rf;
+    TestFan fan;
+  };
+
+  // Boot the nodes at the same moment; slot time 0 sends the moment the channel is clear, as before CSMA/CA
+  void boot(Node *const nodes, const uint32_t slotTime) {
+    for (uint8_t i = 0; i < TEST_CONTENDERS; ++i) {
+      TestFan::Config pairing{0x89ABCDEF, zehnder::FAN_TYPE_REMOTE_CONTROL, (uint8_t) (0x70 + i),
+                              zehnder::FAN_TYPE_MAIN_UNIT, 0x42};
+
+      global_preferences->make_preference<TestFan::Config>(fnv1_hash("zehnderrf_config"), true).save(&pairing);
+      nodes[i].rf.set_emulator(&nodes[i].chip);
+      nodes[i].fan.set_rf(&nodes[i].rf);
+      nodes[i].fan.set_update_interval(TEST_CONTENTION_INTERVAL);
+      nodes[i].fan.set_max_update_interval(TEST_CONTENTION_INTERVAL);
+      nodes[i].fan.set_duty_cycle_limit(1000000);
+      nodes[i].fan.set_csma_slot_time(slotTime);
+      nodes[i].rf.setup();
+      nodes[i].fan.setup();
+    }
+  }
+
+  // Main loop passes for duration (ms); nodes that are not passed in stay quiet
+  void run(Node *const nodes, const uint32_t duration) {
+    const uint32_t end = millis() + duration;
+    uint8_t i;
+
+    while (millis() < end) {
+      nrf905::global_air_medium.update();
+      for (i = 0; (nodes != nullptr) && (i < TEST_CONTENDERS); ++i) {
+        nodes[i].rf.loop();
+        nodes[i].fan.loop();
+      }
+      this->unit_.loop();
+      esphome::testing::runScheduler();
+      esphome::testing::clock().advance(TEST_LOOP_STEP);
+    }
+  }
+
+  // Share of all transmissions of the nodes that went unanswered
+  static float collisionRate(Node *const nodes) {
+    uint32_t answered = 0;
+    uint32_t unanswered = 0;
+
+    for (uint8_t i = 0; i < TEST_CONTENDERS; ++i) {
+      answered += nodes[i].fan.getCsmaStats().answered;
+      unanswered += nodes[i].fan.getCsmaStats().unanswered;
+    }
+
+    return (float) unanswered / std::max(answered + unanswered, (uint32_t) 1);
+  }
+
+  comfofan_emulator::ComfoFanEmulator unit_;
+  Node edge_[TEST_CONTENDERS];
+  Node csma_[TEST_CONTENDERS];
+};
+
+// Random backoff keeps polls that meet apart, where sending on the clear channel edge has them collide
+TEST_F(Contention, BackoffLowersCollisionRate) {
+  float edge;
+  float csma;
+
+  this->unit_.setup();
+  this->boot(this->edge_, 0);
+  this->run(this->edge_, TEST_CONTENTION_TIME);
+  edge = collisionRate(this->edge_);
+
+  this->run(nullptr, 1000);  // Edge nodes fall silent, replies still in flight drain
+  this->boot(this->csma_, FAN_CSMA_SLOT_TIME);
+  this->run(this->csma_, TEST_CONTENTION_TIME);
+  csma = collisionRate(this->csma_);
+
+  EXPECT_GT(edge, 0.5f);
+  EXPECT_LT(csma, edge / 2);
+}
+
+// Only a frame seen before counts as a copy, an all-zero one right after boot included
+TEST(Dedup, EmptyCacheMatchesNothing) {
+  TestFan fan;
+  zehnder::RfFrame frame{};
+
+  EXPECT_FALSE(fan.rfIsDuplicate(&frame, 0));
+  EXPECT_TRUE(fan.rfIsDuplicate(&frame, 10));
+}
+
+// The unit answers two commands in a row with identical frames: the second answer is not a copy of the first
+TEST_F(Bridge, IdenticalAnswersToSuccessiveRequests) {
+  const zehnder::LinkStats &link = this->fan_.getLinkStats();
+  uint32_t timeouts;
+  uint8_t done = 0;
+
+  this->pair();
+  this->boot();
+  this->runUntilStatus(10000);
+  this->run(1000);
+  timeouts = link.timeouts;
+
+  this->fan_.setSpeed(zehnder::FAN_SPEED_MEDIUM, 0, [this, &done](const zehnder::CommandResult result) {
+    EXPECT_EQ(result, zehnder::CommandDone);
+    ++done;
+    this->fan_.setSpeed(zehnder::FAN_SPEED_HIGH, 0, [&done](const zehnder::CommandResult result) {
+      EXPECT_EQ(result, zehnder::CommandDone);
+      ++done;
+    });
+  });
+  this->run(1000);
+
+  EXPECT_EQ(done, 2);
+  EXPECT_EQ(link.timeouts, timeouts);
+}
+
+// First boot ever: discovery and pairing come first
+TEST_F(Bridge, UnpairedBootPairsAndReportsStatusWithin1s) {
+  this->boot();
+  this->runUntilStatus(10000);
+
+  ASSERT_NE(this->fan_.getStartupTime(), 0u);
+  EXPECT_LT(this->fan_.getStartupTime(), 1000u);
+  EXPECT_NE(this->unit_.getTimeToPair(), 0u);
+}
+
+}  // namespace
+}  // namespace esphome
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+#include "esphome/components/nrf905/nRF905RxQueue.h"
+
+namespace esphome {
+namespace nrf905 {
+namespace {
+
+#define TEST_FRAMESIZE 16  // What the Zehnder protocol sends
+#define TEST_FRAMES 200000
+
+typedef RxQueue<8> TestQueue;
+
+// Frame contents follow from the sequence number, so a torn or reordered frame shows
+static bool push(TestQueue *const queue, const uint32_t sequence) {
+  uint8_t data[TEST_FRAMESIZE];
+
+  for (uint8_t i = 0; i < TEST_FRAMESIZE; ++i) {
+    data[i] = (uint8_t) (sequence + i);
+  }
+
+  return queue->push(data, TEST_FRAMESIZE, sequence);
+}
+
+static bool intact(const RxFrame *const frame) {
+  if (frame->length != TEST_FRAMESIZE) {
+    return false;
+  }
+  for (uint8_t i = 0; i < TEST_FRAMESIZE; ++i) {
+    if (frame->data[i] != (uint8_t) (frame->time + i)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+TEST(RxQueue, KeepsOrderAndCountsOverflows) {
+  TestQueue queue;
+
+  for (uint32_t sequence = 0; sequence < queue.capacity() + 3; ++sequence) {
+    EXPECT_EQ(push(&queue, sequence), sequence < queue.capacity());
+  }
+  EXPECT_EQ(queue.size(), queue.capacity());
+  EXPECT_EQ(queue.overflows(), 3u);
+  EXPECT_EQ(queue.highWaterMark(), queue.capacity());
+
+  // The frames that made it are the oldest ones, in order
+  for (uint32_t sequence = 0; sequence < queue.capacity(); ++sequence) {
+    const RxFrame *const frame = queue.front();
+
+    ASSERT_NE(frame, nullptr);
+    EXPECT_EQ(frame->time, sequence);
+    EXPECT_TRUE(intact(frame));
+    queue.pop();
+  }
+  EXPECT_EQ(queue.front(), nullptr);
+  EXPECT_EQ(queue.size(), 0u);
+}
+
+TEST(RxQueue, HighWaterMarkKeepsThePeak) {
+  TestQueue queue;
+
+  for (uint32_t sequence = 0; sequence < 3; ++sequence) {
+    push(&queue, sequence);
+  }
+  for (uint32_t i = 0; i < 3; ++i) {
+    queue.pop();
+  }
+  // Indices run freely: go round the ring a few times at a lower fill level
+  for (uint32_t sequence = 3; sequence < 100; ++sequence) {
+    push(&queue, sequence);
+    queue.pop();
+  }
+
+  EXPECT_EQ(queue.highWaterMark(), 3u);
+  EXPECT_EQ(queue.overflows(), 0u);
+}
+
+// A producer thread standing in for the driver (or its ISR) against a consumer draining it the way ZehnderRF does
+TEST(RxQueue, ProducerThreadAgainstConsumer) {
+  TestQueue queue;
+  std::atomic<bool> done{false};
+  uint32_t received = 0;
+  uint32_t last = 0;
+  bool ordered = true;
+  bool whole = true;
+
+  std::thread producer([&queue, &done]() {
+    for (uint32_t sequence = 1; sequence <= TEST_FRAMES; ++sequence) {
+      push(&queue, sequence);
+    }
+    done.store(true, std::memory_order_release);
+  });
+
+  while (true) {
+    // Read done before draining: everything pushed before it was set is visible to this drain
+    const bool finished = done.load(std::memory_order_acquire);
+    const RxFrame *frame;
+
+    while ((frame = queue.front()) != NULL) {
+      ordered = ordered && (frame->time > last);
+      whole = whole && intact(frame);
+      last = frame->time;
+      ++received;
+      queue.pop();
+    }
+    if (finished) {
+      break;
+    }
+  }
+  producer.join();
+
+  EXPECT_TRUE(ordered);
+  EXPECT_TRUE(whole);
+  EXPECT_EQ(received + queue.overflows(), (uint32_t) TEST_FRAMES);
+  EXPECT_GT(received, 0u);
+  EXPECT_GE(queue.highWaterMark(), 1u);
+  EXPECT_LE(queue.highWaterMark(), queue.capacity());
+  EXPECT_LE(last, (uint32_t) TEST_FRAMES);
+}
+
+}  // namespace
+}  // namespace nrf905
+}  // namespace esphome
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <functional>
+
+#include "esphome/core/entity_base.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/optional.h"
+
+namespace esphome {
+namespace fan {
+
+class FanTraits {
+ public:
+  FanTraits() = default;
+  FanTraits(bool oscillation, bool speed, bool direction, int speed_count)
+      : speed_(speed), speed_count_(speed_count) {}
+  bool supports_speed() const { return this->speed_; }
+  int supported_speed_count() const { return this->speed_count_; }
+
+ protected:
+  bool speed_{false};
+  int speed_count_{0};
+};
+
+class FanCall {
+ public:
+  FanCall &set_state(bool state) {
+    this->state_ = state;
+    return *this;
+  }
+  FanCall &set_speed(int speed) {
+    this->speed_ = speed;
+    return *this;
+  }
+  optional<bool> get_state() const { return this->state_; }
+  optional<int> get_speed() const { return this->speed_; }
+
+ protected:
+  optional<bool> state_;
+  optional<int> speed_;
+};
+
+class Fan : public EntityBase {
+ public:
+  bool state{false};
+  int speed{0};
+  bool oscillating{false};
+
+  virtual FanTraits get_traits() = 0;
+  void publish_state() { this->state_callback_.call(); }
+  void add_on_state_callback(std::function<void()> &&callback) { this->state_callback_.add(std::move(callback)); }
+
+ protected:
+  virtual void control(const FanCall &call) = 0;
+
+  CallbackManager<void()> state_callback_;
+};
+
+class FanState : public Fan {};
+
+}  // namespace fan
+}  // namespace esphome
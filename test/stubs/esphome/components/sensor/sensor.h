@@ -0,0 +1,29 @@
+#pragma once
+
+#include "esphome/core/entity_base.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace sensor {
+
+class Sensor : public EntityBase {
+ public:
+  float state{0.0f};
+
+  bool has_state() const { return this->has_state_; }
+  void publish_state(float state) {
+    this->state = state;
+    this->has_state_ = true;
+  }
+
+ protected:
+  bool has_state_{false};
+};
+
+}  // namespace sensor
+}  // namespace esphome
+
+#define LOG_SENSOR(prefix, type, obj) \
+  if ((obj) != nullptr) { \
+    ESP_LOGCONFIG(TAG, "%s%s '%s'", prefix, type, (obj)->get_name().c_str()); \
+  }
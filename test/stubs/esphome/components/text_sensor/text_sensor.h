@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+
+#include "esphome/core/entity_base.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace text_sensor {
+
+class TextSensor : public EntityBase {
+ public:
+  std::string state;
+
+  bool has_state() const { return this->has_state_; }
+  void publish_state(const std::string &state) {
+    this->state = state;
+    this->has_state_ = true;
+  }
+
+ protected:
+  bool has_state_{false};
+};
+
+}  // namespace text_sensor
+}  // namespace esphome
+
+#define LOG_TEXT_SENSOR(prefix, type, obj) \
+  if ((obj) != nullptr) { \
+    ESP_LOGCONFIG(TAG, "%s%s '%s'", prefix, type, (obj)->get_name().c_str()); \
+  }
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <functional>
+#include <string>
+
+#include "esphome/core/component.h"
+
+namespace esphome {
+
+class Scheduler {
+ public:
+  void set_timeout(Component *component, const std::string &name, uint32_t timeout, std::function<void()> func);
+  bool cancel_timeout(Component *component, const std::string &name);
+};
+
+class Application {
+ public:
+  Scheduler scheduler;
+};
+
+extern Application App;
+
+}  // namespace esphome
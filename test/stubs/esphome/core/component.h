@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <functional>
+#include <string>
+
+#include "esphome/core/optional.h"
+
+namespace esphome {
+
+namespace setup_priority {
+
+extern const float BUS;
+extern const float IO;
+extern const float HARDWARE;
+extern const float DATA;
+extern const float PROCESSOR;
+extern const float WIFI;
+extern const float AFTER_WIFI;
+extern const float AFTER_CONNECTION;
+extern const float LATE;
+
+}  // namespace setup_priority
+
+class Component {
+ public:
+  virtual ~Component() = default;
+  virtual void setup() {}
+  virtual void loop() {}
+  virtual void dump_config() {}
+  virtual void on_shutdown() {}
+  virtual float get_setup_priority() const { return 0.0f; }
+
+  void mark_failed() { this->failed_ = true; }
+  bool is_failed() const { return this->failed_; }
+  void status_set_warning(const char *message = "unspecified") {}
+  void status_clear_warning() {}
+
+ protected:
+  void set_timeout(const std::string &name, uint32_t timeout, std::function<void()> &&f);
+  void set_timeout(uint32_t timeout, std::function<void()> &&f);
+  bool cancel_timeout(const std::string &name);
+  void set_interval(const std::string &name, uint32_t interval, std::function<void()> &&f);
+  void set_interval(uint32_t interval, std::function<void()> &&f);
+  bool cancel_interval(const std::string &name);
+  void defer(std::function<void()> &&f);
+  void defer(const std::string &name, std::function<void()> &&f);
+
+  bool failed_{false};
+};
+
+class PollingComponent : public Component {};
+
+}  // namespace esphome
@@ -0,0 +1,3 @@
+#pragma once
+
+// USE_HOST comes from the build
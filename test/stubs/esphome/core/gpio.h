@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+
+namespace esphome {
+
+namespace gpio {
+
+enum Flags : uint8_t { FLAG_NONE = 0, FLAG_INPUT = 1, FLAG_OUTPUT = 2 };
+enum InterruptType : uint8_t { INTERRUPT_RISING_EDGE = 1, INTERRUPT_FALLING_EDGE = 2, INTERRUPT_ANY_EDGE = 3 };
+
+}  // namespace gpio
+
+class GPIOPin {
+ public:
+  virtual void setup() = 0;
+  virtual void pin_mode(gpio::Flags flags) = 0;
+  virtual bool digital_read() = 0;
+  virtual void digital_write(bool value) = 0;
+  virtual std::string dump_summary() const = 0;
+  virtual bool is_internal() { return false; }
+};
+
+class ISRInternalGPIOPin {
+ public:
+  bool digital_read() { return false; }
+  void digital_write(bool value) {}
+  void clear_interrupt() {}
+};
+
+class InternalGPIOPin : public GPIOPin {
+ public:
+  template<typename T> void attach_interrupt(void (*func)(T *), T *arg, gpio::InterruptType type) const {
+    this->attach_interrupt((void (*)(void *)) func, arg, type);
+  }
+  virtual void detach_interrupt() const = 0;
+  virtual ISRInternalGPIOPin to_isr() const = 0;
+  virtual uint8_t get_pin() const = 0;
+  bool is_internal() override { return true; }
+
+ protected:
+  virtual void attach_interrupt(void (*func)(void *), void *arg, gpio::InterruptType type) const = 0;
+};
+
+}  // namespace esphome
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "esphome/core/optional.h"
+
+namespace esphome {
+
+uint32_t fnv1_hash(const std::string &str);
+uint32_t random_uint32();
+float random_float();
+std::string format_hex_pretty(const uint8_t *data, size_t length);
+std::string get_mac_address();
+
+class HighFrequencyLoopRequester {
+ public:
+  void start() { this->started_ = true; }
+  void stop() { this->started_ = false; }
+  static bool is_high_frequency();
+
+ protected:
+  bool started_{false};
+};
+
+class InterruptLock {
+ public:
+  InterruptLock() {}
+  ~InterruptLock() {}
+};
+
+template<typename T> class CallbackManager;
+template<typename... Ts> class CallbackManager<void(Ts...)> {
+ public:
+  void add(std::function<void(Ts...)> &&callback) { this->callbacks_.push_back(std::move(callback)); }
+  void call(Ts... args) {
+    for (auto &callback : this->callbacks_) {
+      callback(args...);
+    }
+  }
+
+ protected:
+  std::vector<std::function<void(Ts...)>> callbacks_;
+};
+
+}  // namespace esphome
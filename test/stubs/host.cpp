@@ -0,0 +1,210 @@
+#include "host.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "esphome/core/application.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+#include "esphome/core/preferences.h"
+#include "esphome/components/nrf905/nRF905AirMedium.h"
+
+namespace esphome {
+
+namespace testing {
+
+typedef struct {
+  Component *component;
+  std::string name;  // Empty for anonymous ones, which can't be replaced or cancelled
+  uint64_t due;      // us
+  uint32_t interval;  // ms, 0 for a timeout
+  std::function<void()> func;
+  bool cancelled;
+} Timer;
+
+// The components only see 32 bit time, the scheduler keeps the full count so long runs don't wrap
+class HostClock : public nrf905::VirtualClock {
+ public:
+  uint64_t now(void) const { return this->_now; }
+};
+
+static HostClock virtualClock;
+static std::vector<Timer> timers;
+static int logLevel = ESPHOME_LOG_LEVEL_WARN;
+
+static uint64_t now(void) { return virtualClock.now(); }
+
+static void schedule(Component *const component, const std::string &name, const uint32_t delay,
+                     const uint32_t interval, std::function<void()> &&func) {
+  if (!name.empty()) {
+    for (Timer &timer : timers) {
+      if ((timer.component == component) && (timer.name == name)) {
+        timer.cancelled = true;
+      }
+    }
+  }
+  timers.push_back({component, name, now() + (uint64_t) delay * 1000, interval, std::move(func), false});
+}
+
+static bool cancel(Component *const component, const std::string &name) {
+  bool found = false;
+
+  for (Timer &timer : timers) {
+    if ((timer.component == component) && (timer.name == name) && !timer.cancelled) {
+      timer.cancelled = true;
+      found = true;
+    }
+  }
+
+  return found;
+}
+
+nrf905::VirtualClock &clock() { return virtualClock; }
+
+void runScheduler(void) {
+  // Callbacks schedule more timers, so no iterators or references across a call
+  for (size_t i = 0; i < timers.size(); ++i) {
+    if (timers[i].cancelled || (timers[i].due > now())) {
+      continue;
+    }
+
+    std::function<void()> func = timers[i].func;
+    if (timers[i].interval > 0) {
+      timers[i].due += (uint64_t) timers[i].interval * 1000;
+    } else {
+      timers[i].cancelled = true;
+    }
+    func();
+  }
+
+  std::vector<Timer> live;
+  for (Timer &timer : timers) {
+    if (!timer.cancelled) {
+      live.push_back(std::move(timer));
+    }
+  }
+  timers.swap(live);
+}
+
+void loopOnce(std::initializer_list<Component *> components, const uint32_t step) {
+  nrf905::global_air_medium.update();
+  for (Component *const component : components) {
+    component->loop();
+  }
+  runScheduler();
+  virtualClock.advance(step);
+}
+
+void setLogLevel(const int level) { logLevel = level; }
+
+}  // namespace testing
+
+uint32_t millis() { return testing::virtualClock.millis(); }
+uint32_t micros() { return testing::virtualClock.micros(); }
+void delay(uint32_t ms) { testing::virtualClock.delay(ms); }
+void delayMicroseconds(uint32_t us) { testing::virtualClock.advance(us); }
+
+void esp_log_printf_(int level, const char *tag, int line, const char *format, ...) {
+  va_list args;
+
+  if (level > testing::logLevel) {
+    return;
+  }
+
+  printf("[%10.3f][%s] ", testing::virtualClock.micros() / 1000.0, tag);
+  va_start(args, format);
+  vprintf(format, args);
+  va_end(args);
+  printf("\n");
+}
+
+uint32_t fnv1_hash(const std::string &str) {
+  uint32_t hash = 2166136261UL;
+
+  for (const char c : str) {
+    hash *= 16777619UL;
+    hash ^= (uint8_t) c;
+  }
+
+  return hash;
+}
+
+uint32_t random_uint32() {
+  static uint32_t state = 12345;
+
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+
+  return state;
+}
+
+float random_float() { return (random_uint32() & 0xFFFFFF) / (float) 0x1000000; }
+
+std::string format_hex_pretty(const uint8_t *data, size_t length) {
+  std::string result;
+  char hex[4];
+
+  for (size_t i = 0; i < length; ++i) {
+    snprintf(hex, sizeof(hex), (i + 1 < length) ? "%02X." : "%02X", data[i]);
+    result += hex;
+  }
+
+  return result;
+}
+
+std::string get_mac_address() { return "aabbccddee7a"; }
+
+bool HighFrequencyLoopRequester::is_high_frequency() { return false; }
+
+namespace setup_priority {
+
+const float BUS = 1000.0f;
+const float IO = 900.0f;
+const float HARDWARE = 800.0f;
+const float DATA = 600.0f;
+const float PROCESSOR = 400.0f;
+const float WIFI = 250.0f;
+const float AFTER_WIFI = 200.0f;
+const float AFTER_CONNECTION = 100.0f;
+const float LATE = -100.0f;
+
+}  // namespace setup_priority
+
+void Component::set_timeout(const std::string &name, uint32_t timeout, std::function<void()> &&f) {
+  testing::schedule(this, name, timeout, 0, std::move(f));
+}
+void Component::set_timeout(uint32_t timeout, std::function<void()> &&f) {
+  testing::schedule(this, "", timeout, 0, std::move(f));
+}
+bool Component::cancel_timeout(const std::string &name) { return testing::cancel(this, name); }
+void Component::set_interval(const std::string &name, uint32_t interval, std::function<void()> &&f) {
+  testing::schedule(this, name, interval, interval, std::move(f));
+}
+void Component::set_interval(uint32_t interval, std::function<void()> &&f) {
+  testing::schedule(this, "", interval, interval, std::move(f));
+}
+bool Component::cancel_interval(const std::string &name) { return testing::cancel(this, name); }
+void Component::defer(std::function<void()> &&f) { testing::schedule(this, "", 0, 0, std::move(f)); }
+void Component::defer(const std::string &name, std::function<void()> &&f) {
+  testing::schedule(this, name, 0, 0, std::move(f));
+}
+
+void Scheduler::set_timeout(Component *component, const std::string &name, uint32_t timeout,
+                            std::function<void()> func) {
+  testing::schedule(component, name, timeout, 0, std::move(func));
+}
+bool Scheduler::cancel_timeout(Component *component, const std::string &name) {
+  return testing::cancel(component, name);
+}
+
+Application App;
+
+static ESPPreferences preferences;
+ESPPreferences *global_preferences = &preferences;
+
+}  // namespace esphome
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <initializer_list>
+
+#include "esphome/core/component.h"
+#include "esphome/components/nrf905/nRF905Hal.h"
+
+namespace esphome {
+namespace testing {
+
+/* Simulated time for everything in the process: esphome::millis()/micros(), the scheduler and the radio stack.
+ * It only moves when a test advances it, so runs are deterministic and independent of the host's speed. */
+nrf905::VirtualClock &clock();
+
+// Run every scheduled timeout and interval that is due
+void runScheduler(void);
+
+// One main loop pass: air medium, then each component's loop() and the scheduler, then the clock moves on by step
+void loopOnce(std::initializer_list<Component *> components, const uint32_t step);
+
+// Messages up to this level are printed, ESPHOME_LOG_LEVEL_WARN by default
+void setLogLevel(const int level);
+
+}  // namespace testing
+}  // namespace esphome